@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "presenter/bit_expand.h"
+
+using namespace presenter;
+
+using ExpandA8 = void (*)(const uint8_t*, size_t, size_t, uint8_t*, uint8_t);
+using ExpandRgba8 = void (*)(const uint8_t*, size_t, size_t, uint32_t*, uint32_t);
+
+/* Glyph bitmaps as BinaryFontData stores them: `row_count` rows of `row_width` bits, back to back. */
+static std::vector<uint8_t> make_bits(size_t row_count, int row_width, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<uint8_t> bits((row_count * row_width + 7) / 8);
+    for (uint8_t& byte : bits)
+        byte = static_cast<uint8_t>(rng());
+    return bits;
+}
+
+template<typename Pixel, typename Expand, typename Value>
+static void run(const char* name, Expand expand, Value value, const std::vector<uint8_t>& bits, int row_width, int rounds)
+{
+    size_t row_count = bits.size() * 8 / row_width;
+    std::vector<Pixel> pixels(row_width);
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (size_t row = 0; row < row_count; ++row)
+        {
+            expand(bits.data(), row * row_width, row_width, pixels.data(), value);
+            checksum += pixels[row % row_width];
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double pixels_per_second = static_cast<double>(row_count) * row_width * rounds / elapsed.count();
+    std::printf("%-24s %10.2f M pixels/s  (%.3f s, checksum %llu)\n",
+        name, pixels_per_second / 1e6, elapsed.count(), static_cast<unsigned long long>(checksum));
+}
+
+int main()
+{
+    constexpr size_t row_count = 1 << 16;
+    constexpr uint32_t color = 0xff20c0ff;
+
+    /* 12 pixel Latin glyphs start rows mid-byte; 16 pixel CJK glyphs are byte aligned. */
+    for (int row_width : { 12, 16, 64 })
+    {
+        std::vector<uint8_t> bits = make_bits(row_count, row_width, row_width);
+        std::printf("%d pixel rows\n", row_width);
+        run<uint8_t, ExpandA8>("  a8 scalar", expand_bits_a8_scalar, uint8_t(0xff), bits, row_width, 50);
+        run<uint8_t, ExpandA8>("  a8", expand_bits_a8, uint8_t(0xff), bits, row_width, 50);
+        run<uint32_t, ExpandRgba8>("  rgba8 scalar", expand_bits_rgba8_scalar, color, bits, row_width, 50);
+        run<uint32_t, ExpandRgba8>("  rgba8", expand_bits_rgba8, color, bits, row_width, 50);
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "logic_core/hand_evaluator.h"
+
+using namespace logic_core;
+
+/* Build `count` random hands of `size` cards, drawn from a deck with or without jokers. */
+static std::vector<CardSet> make_hands(size_t count, int size, bool with_jokers, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    int deck_size = with_jokers ? Card::INDEX_COUNT : 52;
+
+    std::vector<CardSet> hands(count);
+    for (CardSet& hand : hands)
+    {
+        while (hand.size() < size)
+            hand.insert(Card::from_index(static_cast<int>(rng() % deck_size)));
+    }
+    return hands;
+}
+
+static void run(const char* name, const std::vector<CardSet>& hands, int rounds)
+{
+    std::vector<HandValue> values(hands.size());
+    uint64_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+    {
+        evaluate_hands(hands, values);
+        checksum += values[round % values.size()].get_value();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double hands_per_second = static_cast<double>(hands.size()) * rounds / elapsed.count();
+    std::printf("%-24s %10.2f M hands/s  (%.3f s, checksum %llu)\n",
+        name, hands_per_second / 1e6, elapsed.count(), static_cast<unsigned long long>(checksum));
+}
+
+int main()
+{
+    constexpr size_t hand_count = 1 << 16;
+
+    run("5 cards", make_hands(hand_count, 5, false, 1), 200);
+    run("6 cards", make_hands(hand_count, 6, false, 2), 200);
+    run("7 cards", make_hands(hand_count, 7, false, 3), 200);
+    run("7 cards with jokers", make_hands(hand_count, 7, true, 4), 20);
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "common/math.h"
+
+using namespace pf_math;
+
+/* `count` random transforms: unit rotations, scales around 1, positions on a table. */
+static TransformArray make_transforms(size_t count, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<float> unit(-1.f, 1.f);
+    TransformArray transforms;
+    transforms.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Transform transform;
+        transform.translation = Vec3(unit(rng) * 500.f, unit(rng) * 300.f, unit(rng));
+        transform.rotation = Quat(unit(rng), unit(rng), unit(rng), unit(rng)).normalized();
+        transform.scale = Vec3(1.f + unit(rng) * 0.5f, 1.f + unit(rng) * 0.5f, 1.f);
+        transforms.set(i, transform);
+    }
+    return transforms;
+}
+
+template<typename Kernel>
+static void run(const char* name, size_t count, int rounds, Kernel kernel)
+{
+    float checksum = 0.f;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round)
+        checksum += kernel(round);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double elements_per_second = static_cast<double>(count) * rounds / elapsed.count();
+    std::printf("%-28s %10.2f M elements/s  (%.3f s, checksum %g)\n",
+        name, elements_per_second / 1e6, elapsed.count(), checksum);
+}
+
+/* The textbook triple loop, for comparison with Mat4::operator*. */
+static Mat4 multiply_scalar(const Mat4& a, const Mat4& b)
+{
+    Mat4 result;
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            float sum = 0.f;
+            for (int k = 0; k < 4; ++k)
+                sum += a.m[row][k] * b.m[k][column];
+            result.m[row][column] = sum;
+        }
+    }
+    return result;
+}
+
+int main()
+{
+    /* A deck and chips fit the first size; the second is a particle-sized batch. */
+    for (size_t count : { size_t(64), size_t(1) << 14 })
+    {
+        int rounds = static_cast<int>((size_t(1) << 24) / count);
+        TransformArray from = make_transforms(count, 1);
+        TransformArray to = make_transforms(count, 2);
+        TransformArray interpolated;
+        interpolated.resize(count);
+        std::vector<Mat4> matrices(count);
+        std::vector<Mat4> products(count);
+
+        std::mt19937_64 rng(3);
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+        std::vector<float> t(count);
+        for (float& value : t)
+            value = unit(rng);
+
+        std::vector<float> x(from.translation_x), y(from.translation_y), z(from.translation_z);
+        std::vector<float> out_x(count), out_y(count), out_z(count), out_w(count);
+        Mat4 view_projection = Mat4::look_to_lh(Vec3(0.f, 0.f, -800.f), Vec3(0.f, 0.f, 1.f), Vec3(0.f, 1.f, 0.f)) *
+            Mat4::perspective_fov_lh(0.785f, 16.f / 9.f, 0.1f, 10000.f);
+
+        std::printf("%zu transforms\n", count);
+        run("  compose scalar", count, rounds, [&](int round)
+        {
+            compose_many_scalar(from, matrices.data());
+            return matrices[round % count].m[3][0];
+        });
+        run("  compose", count, rounds, [&](int round)
+        {
+            compose_many(from, matrices.data());
+            return matrices[round % count].m[3][0];
+        });
+        run("  interpolate scalar", count, rounds, [&](int round)
+        {
+            interpolate_many_scalar(from, to, t.data(), interpolated);
+            return interpolated.rotation_w[round % count];
+        });
+        run("  interpolate", count, rounds, [&](int round)
+        {
+            interpolate_many(from, to, t.data(), interpolated);
+            return interpolated.rotation_w[round % count];
+        });
+        run("  transform scalar", count, rounds, [&](int round)
+        {
+            transform_many_scalar(view_projection, x.data(), y.data(), z.data(), count,
+                out_x.data(), out_y.data(), out_z.data(), out_w.data());
+            return out_w[round % count];
+        });
+        run("  transform", count, rounds, [&](int round)
+        {
+            transform_many(view_projection, x.data(), y.data(), z.data(), count,
+                out_x.data(), out_y.data(), out_z.data(), out_w.data());
+            return out_w[round % count];
+        });
+        run("  multiply scalar", count, rounds, [&](int round)
+        {
+            for (size_t i = 0; i < count; ++i)
+                products[i] = multiply_scalar(matrices[i], view_projection);
+            return products[round % count].m[3][3];
+        });
+        run("  multiply", count, rounds, [&](int round)
+        {
+            for (size_t i = 0; i < count; ++i)
+                products[i] = matrices[i] * view_projection;
+            return products[round % count].m[3][3];
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include "math.h"
+
+#include <cassert>
+
+namespace pf_math
+{
+    namespace
+    {
+        /* Four quaternions, one component per register. */
+        struct QuatLanes
+        {
+            simd::Float4 w;
+            simd::Float4 x;
+            simd::Float4 y;
+            simd::Float4 z;
+        };
+
+        /* The corrected interpolation parameter, see interpolate_many(); `d` is |dot(a, b)|. */
+        float correct_slerp_t(float t, float d)
+        {
+            float a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+            float b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+            float k = a * (t - 0.5f) * (t - 0.5f) + b;
+            return t + t * (t - 0.5f) * (t - 1.f) * k;
+        }
+
+        simd::Float4 correct_slerp_t(simd::Float4 t, simd::Float4 d)
+        {
+            using namespace simd;
+            Float4 a = mul_add(d, mul_add(d, mul_add(d, splat(-1.43519f), splat(3.55645f)), splat(-3.2452f)), splat(1.0904f));
+            Float4 b = mul_add(d, mul_add(d, splat(0.215638f), splat(-1.06021f)), splat(0.848013f));
+            Float4 centered = sub(t, splat(0.5f));
+            Float4 k = mul_add(mul(a, centered), centered, b);
+            return mul_add(mul(mul(t, centered), sub(t, splat(1.f))), k, t);
+        }
+
+        void compose_scalar(const TransformArray& transforms, size_t i, Mat4& out)
+        {
+            Transform transform = transforms.get(i);
+            out = Mat4::from_transform(transform);
+        }
+
+        void interpolate_scalar(const TransformArray& from, const TransformArray& to, const float* t, TransformArray& out, size_t i)
+        {
+            float s = t[i];
+            auto lerp = [s](float a, float b) { return a + (b - a) * s; };
+            out.translation_x[i] = lerp(from.translation_x[i], to.translation_x[i]);
+            out.translation_y[i] = lerp(from.translation_y[i], to.translation_y[i]);
+            out.translation_z[i] = lerp(from.translation_z[i], to.translation_z[i]);
+            out.scale_x[i] = lerp(from.scale_x[i], to.scale_x[i]);
+            out.scale_y[i] = lerp(from.scale_y[i], to.scale_y[i]);
+            out.scale_z[i] = lerp(from.scale_z[i], to.scale_z[i]);
+
+            Quat a(from.rotation_w[i], from.rotation_x[i], from.rotation_y[i], from.rotation_z[i]);
+            Quat b(to.rotation_w[i], to.rotation_x[i], to.rotation_y[i], to.rotation_z[i]);
+            float dot = a.dot(b);
+            Quat q = Quat::nlerp(a, b, correct_slerp_t(s, std::fabs(dot)));
+            out.rotation_w[i] = q.w;
+            out.rotation_x[i] = q.x;
+            out.rotation_y[i] = q.y;
+            out.rotation_z[i] = q.z;
+        }
+
+        void transform_scalar(const Mat4& matrix, const float* x, const float* y, const float* z, size_t i,
+            float* out_x, float* out_y, float* out_z, float* out_w)
+        {
+            const float (*m)[4] = matrix.m;
+            out_x[i] = x[i] * m[0][0] + y[i] * m[1][0] + z[i] * m[2][0] + m[3][0];
+            out_y[i] = x[i] * m[0][1] + y[i] * m[1][1] + z[i] * m[2][1] + m[3][1];
+            out_z[i] = x[i] * m[0][2] + y[i] * m[1][2] + z[i] * m[2][2] + m[3][2];
+            out_w[i] = x[i] * m[0][3] + y[i] * m[1][3] + z[i] * m[2][3] + m[3][3];
+        }
+    }
+
+    void TransformArray::resize(size_t count)
+    {
+        translation_x.resize(count, 0.f);
+        translation_y.resize(count, 0.f);
+        translation_z.resize(count, 0.f);
+        rotation_w.resize(count, 1.f);
+        rotation_x.resize(count, 0.f);
+        rotation_y.resize(count, 0.f);
+        rotation_z.resize(count, 0.f);
+        scale_x.resize(count, 1.f);
+        scale_y.resize(count, 1.f);
+        scale_z.resize(count, 1.f);
+    }
+
+    void TransformArray::set(size_t index, const Transform& transform)
+    {
+        translation_x[index] = transform.translation.x;
+        translation_y[index] = transform.translation.y;
+        translation_z[index] = transform.translation.z;
+        rotation_w[index] = transform.rotation.w;
+        rotation_x[index] = transform.rotation.x;
+        rotation_y[index] = transform.rotation.y;
+        rotation_z[index] = transform.rotation.z;
+        scale_x[index] = transform.scale.x;
+        scale_y[index] = transform.scale.y;
+        scale_z[index] = transform.scale.z;
+    }
+
+    Transform TransformArray::get(size_t index) const
+    {
+        Transform transform;
+        transform.translation = Vec3(translation_x[index], translation_y[index], translation_z[index]);
+        transform.rotation = Quat(rotation_w[index], rotation_x[index], rotation_y[index], rotation_z[index]);
+        transform.scale = Vec3(scale_x[index], scale_y[index], scale_z[index]);
+        return transform;
+    }
+
+    void compose_many(const TransformArray& transforms, Mat4* out_matrices)
+    {
+        using namespace simd;
+        size_t count = transforms.size();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            Float4 qw = load(&transforms.rotation_w[i]);
+            Float4 qx = load(&transforms.rotation_x[i]);
+            Float4 qy = load(&transforms.rotation_y[i]);
+            Float4 qz = load(&transforms.rotation_z[i]);
+            Float4 sx = load(&transforms.scale_x[i]);
+            Float4 sy = load(&transforms.scale_y[i]);
+            Float4 sz = load(&transforms.scale_z[i]);
+
+            Float4 two = splat(2.f);
+            Float4 one = splat(1.f);
+            Float4 xx = mul(qx, qx), yy = mul(qy, qy), zz = mul(qz, qz);
+            Float4 xy = mul(qx, qy), xz = mul(qx, qz), yz = mul(qy, qz);
+            Float4 wx = mul(qw, qx), wy = mul(qw, qy), wz = mul(qw, qz);
+
+            /* Row r of the four matrices, one Float4 per column; transposed into one Float4 per matrix. */
+            Float4 rows[4][4] = {
+                { mul(sub(one, mul(two, add(yy, zz))), sx), mul(mul(two, add(xy, wz)), sx), mul(mul(two, sub(xz, wy)), sx), splat(0.f) },
+                { mul(mul(two, sub(xy, wz)), sy), mul(sub(one, mul(two, add(xx, zz))), sy), mul(mul(two, add(yz, wx)), sy), splat(0.f) },
+                { mul(mul(two, add(xz, wy)), sz), mul(mul(two, sub(yz, wx)), sz), mul(sub(one, mul(two, add(xx, yy))), sz), splat(0.f) },
+                { load(&transforms.translation_x[i]), load(&transforms.translation_y[i]), load(&transforms.translation_z[i]), one },
+            };
+            for (int row = 0; row < 4; ++row)
+            {
+                Float4* columns = rows[row];
+                transpose4(columns[0], columns[1], columns[2], columns[3]);
+                for (int lane = 0; lane < 4; ++lane)
+                    store(out_matrices[i + lane].m[row], columns[lane]);
+            }
+        }
+        for (; i < count; ++i)
+            compose_scalar(transforms, i, out_matrices[i]);
+    }
+
+    void compose_many_scalar(const TransformArray& transforms, Mat4* out_matrices)
+    {
+        for (size_t i = 0; i < transforms.size(); ++i)
+            compose_scalar(transforms, i, out_matrices[i]);
+    }
+
+    void interpolate_many(const TransformArray& from, const TransformArray& to, const float* t, TransformArray& out)
+    {
+        using namespace simd;
+        assert(from.size() == to.size() && from.size() == out.size());
+        size_t count = from.size();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            Float4 s = load(t + i);
+            auto lerp = [&](const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& result)
+            {
+                Float4 start = load(&a[i]);
+                store(&result[i], mul_add(sub(load(&b[i]), start), s, start));
+            };
+
+            QuatLanes a = { load(&from.rotation_w[i]), load(&from.rotation_x[i]), load(&from.rotation_y[i]), load(&from.rotation_z[i]) };
+            QuatLanes b = { load(&to.rotation_w[i]), load(&to.rotation_x[i]), load(&to.rotation_y[i]), load(&to.rotation_z[i]) };
+
+            lerp(from.translation_x, to.translation_x, out.translation_x);
+            lerp(from.translation_y, to.translation_y, out.translation_y);
+            lerp(from.translation_z, to.translation_z, out.translation_z);
+            lerp(from.scale_x, to.scale_x, out.scale_x);
+            lerp(from.scale_y, to.scale_y, out.scale_y);
+            lerp(from.scale_z, to.scale_z, out.scale_z);
+
+            /* The shorter arc: flip b by the sign of the dot product, which also makes it |dot|. */
+            Float4 dot = mul_add(a.w, b.w, mul_add(a.x, b.x, mul_add(a.y, b.y, mul(a.z, b.z))));
+            Float4 sign = bit_and(dot, splat(-0.f));
+            dot = bit_xor(dot, sign);
+
+            Float4 corrected = correct_slerp_t(s, dot);
+            Float4 u = bit_xor(corrected, sign);
+            Float4 v = sub(splat(1.f), corrected);
+            Float4 qw = mul_add(a.w, v, mul(b.w, u));
+            Float4 qx = mul_add(a.x, v, mul(b.x, u));
+            Float4 qy = mul_add(a.y, v, mul(b.y, u));
+            Float4 qz = mul_add(a.z, v, mul(b.z, u));
+            Float4 inverse_length = div(splat(1.f), sqrt(mul_add(qw, qw, mul_add(qx, qx, mul_add(qy, qy, mul(qz, qz))))));
+            store(&out.rotation_w[i], mul(qw, inverse_length));
+            store(&out.rotation_x[i], mul(qx, inverse_length));
+            store(&out.rotation_y[i], mul(qy, inverse_length));
+            store(&out.rotation_z[i], mul(qz, inverse_length));
+        }
+        for (; i < count; ++i)
+            interpolate_scalar(from, to, t, out, i);
+    }
+
+    void interpolate_many_scalar(const TransformArray& from, const TransformArray& to, const float* t, TransformArray& out)
+    {
+        assert(from.size() == to.size() && from.size() == out.size());
+        for (size_t i = 0; i < from.size(); ++i)
+            interpolate_scalar(from, to, t, out, i);
+    }
+
+    void transform_many(const Mat4& matrix, const float* x, const float* y, const float* z, size_t count,
+        float* out_x, float* out_y, float* out_z, float* out_w)
+    {
+        using namespace simd;
+        const float (*m)[4] = matrix.m;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            Float4 px = load(x + i);
+            Float4 py = load(y + i);
+            Float4 pz = load(z + i);
+            float* out[4] = { out_x, out_y, out_z, out_w };
+            for (int column = 0; column < 4; ++column)
+            {
+                Float4 sum = mul_add(px, splat(m[0][column]), splat(m[3][column]));
+                sum = mul_add(py, splat(m[1][column]), sum);
+                sum = mul_add(pz, splat(m[2][column]), sum);
+                store(out[column] + i, sum);
+            }
+        }
+        for (; i < count; ++i)
+            transform_scalar(matrix, x, y, z, i, out_x, out_y, out_z, out_w);
+    }
+
+    void transform_many_scalar(const Mat4& matrix, const float* x, const float* y, const float* z, size_t count,
+        float* out_x, float* out_y, float* out_z, float* out_w)
+    {
+        for (size_t i = 0; i < count; ++i)
+            transform_scalar(matrix, x, y, z, i, out_x, out_y, out_z, out_w);
+    }
+}
@@ -1,40 +1,227 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PF_MATH_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PF_MATH_NEON
+#endif
+
 namespace pf_math
 {
+    /*
+     * Four floats in one SIMD register: SSE2 on x86, NEON on ARM64 and a plain array
+     * elsewhere. The vector code of pf_math is written once against these functions.
+     */
+    namespace simd
+    {
+#if defined(PF_MATH_SSE2)
+        using Float4 = __m128;
+
+        inline Float4 load(const float* p) { return _mm_loadu_ps(p); }
+        inline void store(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+        inline Float4 splat(float value) { return _mm_set1_ps(value); }
+        inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+        inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+        inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+        inline Float4 div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+        inline Float4 sqrt(Float4 v) { return _mm_sqrt_ps(v); }
+        inline Float4 bit_and(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+        inline Float4 bit_xor(Float4 a, Float4 b) { return _mm_xor_ps(a, b); }
+        inline void transpose4(Float4& a, Float4& b, Float4& c, Float4& d) { _MM_TRANSPOSE4_PS(a, b, c, d); }
+#elif defined(PF_MATH_NEON)
+        using Float4 = float32x4_t;
+
+        inline Float4 load(const float* p) { return vld1q_f32(p); }
+        inline void store(float* p, Float4 v) { vst1q_f32(p, v); }
+        inline Float4 splat(float value) { return vdupq_n_f32(value); }
+        inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+        inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+        inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+        inline Float4 div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+        inline Float4 sqrt(Float4 v) { return vsqrtq_f32(v); }
+        inline Float4 bit_and(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+        inline Float4 bit_xor(Float4 a, Float4 b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+        inline void transpose4(Float4& a, Float4& b, Float4& c, Float4& d)
+        {
+            float32x4x2_t ab = vtrnq_f32(a, b);
+            float32x4x2_t cd = vtrnq_f32(c, d);
+            a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+            b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+            c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+            d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+        }
+#else
+        struct Float4
+        {
+            float v[4];
+        };
+
+        template<typename Op>
+        inline Float4 apply(Float4 a, Float4 b, Op op)
+        {
+            return Float4{ { op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]) } };
+        }
+
+        template<typename Op>
+        inline Float4 apply_bits(Float4 a, Float4 b, Op op)
+        {
+            return apply(a, b, [op](float x, float y)
+            {
+                unsigned int x_bits, y_bits;
+                std::memcpy(&x_bits, &x, 4);
+                std::memcpy(&y_bits, &y, 4);
+                x_bits = op(x_bits, y_bits);
+                std::memcpy(&x, &x_bits, 4);
+                return x;
+            });
+        }
+
+        inline Float4 load(const float* p) { return Float4{ { p[0], p[1], p[2], p[3] } }; }
+        inline void store(float* p, Float4 v) { p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3]; }
+        inline Float4 splat(float value) { return Float4{ { value, value, value, value } }; }
+        inline Float4 add(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x + y; }); }
+        inline Float4 sub(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x - y; }); }
+        inline Float4 mul(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x * y; }); }
+        inline Float4 div(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x / y; }); }
+        inline Float4 sqrt(Float4 v) { return apply(v, v, [](float x, float) { return std::sqrt(x); }); }
+        inline Float4 bit_and(Float4 a, Float4 b) { return apply_bits(a, b, [](unsigned int x, unsigned int y) { return x & y; }); }
+        inline Float4 bit_xor(Float4 a, Float4 b) { return apply_bits(a, b, [](unsigned int x, unsigned int y) { return x ^ y; }); }
+        inline void transpose4(Float4& a, Float4& b, Float4& c, Float4& d)
+        {
+            Float4 rows[4] = { a, b, c, d };
+            a = Float4{ { rows[0].v[0], rows[1].v[0], rows[2].v[0], rows[3].v[0] } };
+            b = Float4{ { rows[0].v[1], rows[1].v[1], rows[2].v[1], rows[3].v[1] } };
+            c = Float4{ { rows[0].v[2], rows[1].v[2], rows[2].v[2], rows[3].v[2] } };
+            d = Float4{ { rows[0].v[3], rows[1].v[3], rows[2].v[3], rows[3].v[3] } };
+        }
+#endif
+
+        /* a * b + c */
+        inline Float4 mul_add(Float4 a, Float4 b, Float4 c) { return add(mul(a, b), c); }
+    }
+
+    class Vec2
+    {
+    public:
+        Vec2() : x(0.f), y(0.f) {}
+        Vec2(float x, float y) : x(x), y(y) {}
+
+    public:
+        float x;
+        float y;
+    };
+
     class Vec3
     {
     public:
         Vec3() : x(0.f), y(0.f), z(0.f) {}
         Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
 
-        Vec3 operator+(const Vec3& other)
+        Vec3 operator+(const Vec3& other) const
         {
             return Vec3(x + other.x, y + other.y, z + other.z);
         }
 
-        Vec3 operator-(const Vec3& other)
+        Vec3 operator-(const Vec3& other) const
         {
             return Vec3(x - other.x, y - other.y, z - other.z);
         }
 
-        Vec3 operator*(const Vec3& other)
+        Vec3 operator-() const
+        {
+            return Vec3(-x, -y, -z);
+        }
+
+        Vec3 operator*(const Vec3& other) const
         {
             return Vec3(x * other.x, y * other.y, z * other.z);
         }
 
-        Vec3 operator*(float multiplier)
+        Vec3 operator*(float multiplier) const
         {
             return Vec3(x * multiplier, y * multiplier, z * multiplier);
         }
 
-        Vec3 operator/(float divider)
+        Vec3 operator/(float divider) const
         {
             return Vec3(x / divider, y / divider, z / divider);
         }
 
+        float dot(const Vec3& other) const
+        {
+            return x * other.x + y * other.y + z * other.z;
+        }
+
+        Vec3 cross(const Vec3& other) const
+        {
+            return Vec3(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x);
+        }
+
+        float length() const
+        {
+            return std::sqrt(dot(*this));
+        }
+
+        Vec3 normalized() const
+        {
+            return *this / length();
+        }
+
+        static Vec3 lerp(const Vec3& a, const Vec3& b, float t)
+        {
+            return a + (b - a) * t;
+        }
+
+    public:
+        float x;
+        float y;
+        float z;
+    };
+
+    class Vec4
+    {
+    public:
+        Vec4() : x(0.f), y(0.f), z(0.f), w(0.f) {}
+        Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+        Vec4(const Vec3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+        Vec4 operator+(const Vec4& other) const
+        {
+            return Vec4(x + other.x, y + other.y, z + other.z, w + other.w);
+        }
+
+        Vec4 operator-(const Vec4& other) const
+        {
+            return Vec4(x - other.x, y - other.y, z - other.z, w - other.w);
+        }
+
+        Vec4 operator*(float multiplier) const
+        {
+            return Vec4(x * multiplier, y * multiplier, z * multiplier, w * multiplier);
+        }
+
+        float dot(const Vec4& other) const
+        {
+            return x * other.x + y * other.y + z * other.z + w * other.w;
+        }
+
+        Vec3 xyz() const
+        {
+            return Vec3(x, y, z);
+        }
+
     public:
         float x;
         float y;
         float z;
+        float w;
     };
 
     class Quat
@@ -43,6 +230,74 @@ namespace pf_math
         Quat() : w(1.f), x(0.f), y(0.f), z(0.f) {}
         Quat(float w, float x, float y, float z) : w(w), x(x), y(y), z(z) {}
 
+        /* Rotation by `angle` radians about the unit vector `axis`. */
+        static Quat from_axis_angle(const Vec3& axis, float angle)
+        {
+            float s = std::sin(angle * 0.5f);
+            return Quat(std::cos(angle * 0.5f), axis.x * s, axis.y * s, axis.z * s);
+        }
+
+        /* Rotation by `other`, then by this one. */
+        Quat operator*(const Quat& other) const
+        {
+            return Quat(
+                w * other.w - x * other.x - y * other.y - z * other.z,
+                w * other.x + x * other.w + y * other.z - z * other.y,
+                w * other.y - x * other.z + y * other.w + z * other.x,
+                w * other.z + x * other.y - y * other.x + z * other.w);
+        }
+
+        Quat conjugate() const
+        {
+            return Quat(w, -x, -y, -z);
+        }
+
+        float dot(const Quat& other) const
+        {
+            return w * other.w + x * other.x + y * other.y + z * other.z;
+        }
+
+        Quat normalized() const
+        {
+            float inverse_length = 1.f / std::sqrt(dot(*this));
+            return Quat(w * inverse_length, x * inverse_length, y * inverse_length, z * inverse_length);
+        }
+
+        /* `v` rotated by this unit quaternion. */
+        Vec3 rotate(const Vec3& v) const
+        {
+            Vec3 u(x, y, z);
+            Vec3 t = u.cross(v) * 2.f;
+            return v + t * w + u.cross(t);
+        }
+
+        /* Normalized linear interpolation along the shorter arc: cheap, but not at constant speed. */
+        static Quat nlerp(const Quat& a, const Quat& b, float t)
+        {
+            float sign = a.dot(b) < 0.f ? -1.f : 1.f;
+            float s = 1.f - t;
+            float u = t * sign;
+            return Quat(a.w * s + b.w * u, a.x * s + b.x * u, a.y * s + b.y * u, a.z * s + b.z * u).normalized();
+        }
+
+        /* Spherical linear interpolation of unit quaternions along the shorter arc, at constant angular speed. */
+        static Quat slerp(const Quat& a, const Quat& b, float t)
+        {
+            float cos_angle = a.dot(b);
+            float sign = cos_angle < 0.f ? -1.f : 1.f;
+            cos_angle *= sign;
+
+            /* Nearly equal rotations: the sine below would vanish, and linear is exact enough. */
+            if (cos_angle > 0.9995f)
+                return nlerp(a, b, t);
+
+            float angle = std::acos(cos_angle);
+            float inverse_sin = 1.f / std::sin(angle);
+            float s = std::sin((1.f - t) * angle) * inverse_sin;
+            float u = std::sin(t * angle) * inverse_sin * sign;
+            return Quat(a.w * s + b.w * u, a.x * s + b.x * u, a.y * s + b.y * u, a.z * s + b.z * u);
+        }
+
     public:
         float w;
         float x;
@@ -64,6 +319,209 @@ namespace pf_math
     public:
         Vec3 translation;
         Quat rotation;
-        Vec3 scale;
+        Vec3 scale = Vec3(1.f, 1.f, 1.f);
     };
-}
\ No newline at end of file
+
+    /*
+     * Row-major 4x4 matrix for row vectors, as in DirectXMath: a point is transformed as
+     * v * M, and A * B applies A first. Rows are 16 byte aligned for SIMD loads.
+     */
+    class alignas(16) Mat4
+    {
+    public:
+        /* Identity. */
+        Mat4() : m{ { 1.f, 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f, 0.f }, { 0.f, 0.f, 0.f, 1.f } } {}
+
+        Mat4 operator*(const Mat4& other) const
+        {
+            using namespace simd;
+            Float4 rows[4] = { load(other.m[0]), load(other.m[1]), load(other.m[2]), load(other.m[3]) };
+            Mat4 result;
+            for (int row = 0; row < 4; ++row)
+            {
+                Float4 sum = mul(splat(m[row][0]), rows[0]);
+                sum = mul_add(splat(m[row][1]), rows[1], sum);
+                sum = mul_add(splat(m[row][2]), rows[2], sum);
+                sum = mul_add(splat(m[row][3]), rows[3], sum);
+                store(result.m[row], sum);
+            }
+            return result;
+        }
+
+        Vec4 transform(const Vec4& v) const
+        {
+            using namespace simd;
+            Float4 sum = mul(splat(v.x), load(m[0]));
+            sum = mul_add(splat(v.y), load(m[1]), sum);
+            sum = mul_add(splat(v.z), load(m[2]), sum);
+            sum = mul_add(splat(v.w), load(m[3]), sum);
+            alignas(16) float result[4];
+            store(result, sum);
+            return Vec4(result[0], result[1], result[2], result[3]);
+        }
+
+        /* The point `p`, w = 1, transformed. */
+        Vec4 transform_point(const Vec3& p) const
+        {
+            return transform(Vec4(p, 1.f));
+        }
+
+        Mat4 transposed() const
+        {
+            Mat4 result;
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 4; ++column)
+                    result.m[row][column] = m[column][row];
+            }
+            return result;
+        }
+
+        static Mat4 translation(const Vec3& offset)
+        {
+            Mat4 result;
+            result.m[3][0] = offset.x;
+            result.m[3][1] = offset.y;
+            result.m[3][2] = offset.z;
+            return result;
+        }
+
+        static Mat4 scaling(const Vec3& scale)
+        {
+            Mat4 result;
+            result.m[0][0] = scale.x;
+            result.m[1][1] = scale.y;
+            result.m[2][2] = scale.z;
+            return result;
+        }
+
+        static Mat4 rotation(const Quat& rotation)
+        {
+            Transform transform;
+            transform.rotation = rotation;
+            return from_transform(transform);
+        }
+
+        /* Scale, then rotate, then translate. The rotation must be a unit quaternion. */
+        static Mat4 from_transform(const Transform& transform)
+        {
+            const Quat& q = transform.rotation;
+            const Vec3& s = transform.scale;
+            Mat4 result;
+            result.m[0][0] = (1.f - 2.f * (q.y * q.y + q.z * q.z)) * s.x;
+            result.m[0][1] = 2.f * (q.x * q.y + q.z * q.w) * s.x;
+            result.m[0][2] = 2.f * (q.x * q.z - q.y * q.w) * s.x;
+            result.m[1][0] = 2.f * (q.x * q.y - q.z * q.w) * s.y;
+            result.m[1][1] = (1.f - 2.f * (q.x * q.x + q.z * q.z)) * s.y;
+            result.m[1][2] = 2.f * (q.y * q.z + q.x * q.w) * s.y;
+            result.m[2][0] = 2.f * (q.x * q.z + q.y * q.w) * s.z;
+            result.m[2][1] = 2.f * (q.y * q.z - q.x * q.w) * s.z;
+            result.m[2][2] = (1.f - 2.f * (q.x * q.x + q.y * q.y)) * s.z;
+            result.m[3][0] = transform.translation.x;
+            result.m[3][1] = transform.translation.y;
+            result.m[3][2] = transform.translation.z;
+            return result;
+        }
+
+        /* Left-handed view of a camera at `eye` looking along `direction`, like XMMatrixLookToLH. */
+        static Mat4 look_to_lh(const Vec3& eye, const Vec3& direction, const Vec3& up)
+        {
+            Vec3 z_axis = direction.normalized();
+            Vec3 x_axis = up.cross(z_axis).normalized();
+            Vec3 y_axis = z_axis.cross(x_axis);
+            Mat4 result;
+            result.m[0][0] = x_axis.x;
+            result.m[0][1] = y_axis.x;
+            result.m[0][2] = z_axis.x;
+            result.m[1][0] = x_axis.y;
+            result.m[1][1] = y_axis.y;
+            result.m[1][2] = z_axis.y;
+            result.m[2][0] = x_axis.z;
+            result.m[2][1] = y_axis.z;
+            result.m[2][2] = z_axis.z;
+            result.m[3][0] = -x_axis.dot(eye);
+            result.m[3][1] = -y_axis.dot(eye);
+            result.m[3][2] = -z_axis.dot(eye);
+            return result;
+        }
+
+        /* Left-handed perspective projection to a depth range of [0, 1], like XMMatrixPerspectiveFovLH. */
+        static Mat4 perspective_fov_lh(float fov_y, float aspect_ratio, float near_z, float far_z)
+        {
+            float height = 1.f / std::tan(fov_y * 0.5f);
+            float range = far_z / (far_z - near_z);
+            Mat4 result;
+            result.m[0][0] = height / aspect_ratio;
+            result.m[1][1] = height;
+            result.m[2][2] = range;
+            result.m[2][3] = 1.f;
+            result.m[3][2] = -range * near_z;
+            result.m[3][3] = 0.f;
+            return result;
+        }
+
+        /*
+         * Orthographic projection of the pixels of a `width` x `height` screen, y down from the
+         * top left corner, and z in [near_z, far_z] to a depth range of [0, 1]. For 2D and UI.
+         */
+        static Mat4 orthographic_screen(float width, float height, float near_z, float far_z)
+        {
+            Mat4 result;
+            result.m[0][0] = 2.f / width;
+            result.m[1][1] = -2.f / height;
+            result.m[2][2] = 1.f / (far_z - near_z);
+            result.m[3][0] = -1.f;
+            result.m[3][1] = 1.f;
+            result.m[3][2] = -near_z / (far_z - near_z);
+            return result;
+        }
+
+    public:
+        float m[4][4];
+    };
+
+    /*
+     * Transforms as a structure of arrays, e.g. one element per card, for the batched kernels
+     * below: each of them works on four elements per SIMD instruction.
+     */
+    class TransformArray
+    {
+    public:
+        size_t size() const { return translation_x.size(); }
+        void resize(size_t count);
+
+        void set(size_t index, const Transform& transform);
+        Transform get(size_t index) const;
+
+    public:
+        std::vector<float> translation_x;
+        std::vector<float> translation_y;
+        std::vector<float> translation_z;
+        std::vector<float> rotation_w;
+        std::vector<float> rotation_x;
+        std::vector<float> rotation_y;
+        std::vector<float> rotation_z;
+        std::vector<float> scale_x;
+        std::vector<float> scale_y;
+        std::vector<float> scale_z;
+    };
+
+    /* Mat4::from_transform() of every element of `transforms`, to `out_matrices`. */
+    void compose_many(const TransformArray& transforms, Mat4* out_matrices);
+    void compose_many_scalar(const TransformArray& transforms, Mat4* out_matrices);
+
+    /*
+     * Interpolate element i of `from` to `to` by `t[i]`: translation and scale linearly,
+     * rotation along the shorter arc. The rotation uses a fitted correction of nlerp that
+     * follows slerp's constant speed to within 2e-3 radians, without trigonometry.
+     * `out` may be `from` or `to`; all three must have the same size.
+     */
+    void interpolate_many(const TransformArray& from, const TransformArray& to, const float* t, TransformArray& out);
+    void interpolate_many_scalar(const TransformArray& from, const TransformArray& to, const float* t, TransformArray& out);
+
+    /* The points (x[i], y[i], z[i], 1) transformed by `matrix`, to the four output arrays. */
+    void transform_many(const Mat4& matrix, const float* x, const float* y, const float* z, size_t count,
+        float* out_x, float* out_y, float* out_z, float* out_w);
+    void transform_many_scalar(const Mat4& matrix, const float* x, const float* y, const float* z, size_t count,
+        float* out_x, float* out_y, float* out_z, float* out_w);
+}
@@ -5,7 +5,7 @@
 
 namespace pf_math
 {
-    RECT to_dx(const Rect& rect)
+    inline RECT to_dx(const Rect& rect)
     {
         RECT res;
         res.left = rect.x_min;
@@ -14,4 +14,10 @@ namespace pf_math
         res.bottom = rect.y_max;
         return res;
     }
+
+    /* Both are row-major for row vectors, so the elements copy as they are. */
+    inline DirectX::XMMATRIX to_dx(const Mat4& matrix)
+    {
+        return DirectX::XMMATRIX(&matrix.m[0][0]);
+    }
 };
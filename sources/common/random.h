@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace pf
+{
+    /* SplitMix64. Used to expand a single seed into well mixed generator states. */
+    class SplitMix64
+    {
+    public:
+        constexpr explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+        constexpr uint64_t next()
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+    private:
+        uint64_t state;
+    };
+
+    /* Combine a seed with a stream index, e.g. a task or game number, into an independent seed. */
+    constexpr uint64_t mix_seed(uint64_t seed, uint64_t stream)
+    {
+        SplitMix64 mixer(seed ^ (stream * 0xd1b54a32d192ed03ull));
+        mixer.next();
+        return mixer.next();
+    }
+
+    /*
+     * xoshiro256++ by Blackman and Vigna. Small and fast, meant to live on the stack of the
+     * thread that uses it; never share one instance between threads.
+     */
+    class Xoshiro256
+    {
+    public:
+        constexpr explicit Xoshiro256(uint64_t seed)
+        {
+            SplitMix64 mixer(seed);
+            for (uint64_t& word : state)
+                word = mixer.next();
+        }
+
+        constexpr uint64_t next()
+        {
+            uint64_t result = std::rotl(state[0] + state[3], 23) + state[0];
+            uint64_t t = state[1] << 17;
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = std::rotl(state[3], 45);
+            return result;
+        }
+
+        /* Uniform integer in [0, range), range > 0. Lemire's multiply-shift with rejection. */
+        constexpr uint32_t next_below(uint32_t range)
+        {
+            uint64_t product = (next() >> 32) * range;
+            uint32_t low = static_cast<uint32_t>(product);
+            if (low < range)
+            {
+                uint32_t threshold = -range % range;
+                while (low < threshold)
+                {
+                    product = (next() >> 32) * range;
+                    low = static_cast<uint32_t>(product);
+                }
+            }
+            return static_cast<uint32_t>(product >> 32);
+        }
+
+        /* Uniform double in [0, 1). */
+        constexpr double next_double()
+        {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+
+    private:
+        uint64_t state[4] = {};
+    };
+
+    /*
+     * Philox4x32-10 by Salmon et al. A counter-based generator: every 128-bit counter maps to
+     * four independent random words under a 64-bit key, so value n of a stream is computed
+     * directly instead of by stepping through the n values before it.
+     */
+    class Philox4x32
+    {
+    public:
+        using Block = std::array<uint32_t, 4>;
+
+        constexpr explicit Philox4x32(uint64_t key) : key{ static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32) } {}
+
+        constexpr Block generate(uint64_t counter_low, uint64_t counter_high = 0) const
+        {
+            Block block = {
+                static_cast<uint32_t>(counter_low), static_cast<uint32_t>(counter_low >> 32),
+                static_cast<uint32_t>(counter_high), static_cast<uint32_t>(counter_high >> 32) };
+            uint32_t k0 = key[0];
+            uint32_t k1 = key[1];
+            for (int round = 0; round < 10; ++round)
+            {
+                uint64_t product0 = uint64_t(0xd2511f53u) * block[0];
+                uint64_t product1 = uint64_t(0xcd9e8d57u) * block[2];
+                block = {
+                    static_cast<uint32_t>(product1 >> 32) ^ block[1] ^ k0, static_cast<uint32_t>(product1),
+                    static_cast<uint32_t>(product0 >> 32) ^ block[3] ^ k1, static_cast<uint32_t>(product0) };
+                k0 += 0x9e3779b9u;
+                k1 += 0xbb67ae85u;
+            }
+            return block;
+        }
+
+    private:
+        uint32_t key[2];
+    };
+
+    /* Known-answer vectors of Philox4x32-10 from Random123's kat_vectors. */
+    static_assert(Philox4x32(0).generate(0, 0) == Philox4x32::Block{ 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u });
+    static_assert(Philox4x32(0xffffffffffffffffull).generate(0xffffffffffffffffull, 0xffffffffffffffffull) ==
+        Philox4x32::Block{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu });
+    static_assert(Philox4x32(0x299f31d0a4093822ull).generate(0x85a308d3243f6a88ull, 0x0370734413198a2eull) ==
+        Philox4x32::Block{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u });
+}
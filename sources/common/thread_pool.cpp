@@ -0,0 +1,140 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace pf
+{
+    static thread_local const ThreadPool* current_pool = nullptr;
+    static thread_local unsigned current_worker_index = 0;
+
+    ThreadPool::ThreadPool(unsigned thread_count)
+    {
+        if (thread_count == 0)
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+        for (unsigned i = 0; i < thread_count; ++i)
+            queues.push_back(std::make_unique<WorkerQueue>());
+
+        for (unsigned i = 0; i < thread_count; ++i)
+            threads.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            is_stopping = true;
+        }
+        wake_condition.notify_all();
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    unsigned ThreadPool::get_worker_index() const
+    {
+        return current_pool == this ? current_worker_index : get_thread_count();
+    }
+
+    void ThreadPool::submit(Task task)
+    {
+        unsigned index = get_worker_index();
+        if (index == get_thread_count())
+            index = next_queue.fetch_add(1, std::memory_order_relaxed) % get_thread_count();
+
+        /* Count the task before it becomes visible, so a thief's decrement can never wrap the counter. */
+        pending_count.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+
+        /* Taking the lock orders the wake-up after a worker's check of pending_count. */
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        wake_condition.notify_one();
+    }
+
+    void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)>& task)
+    {
+        std::atomic<size_t> remaining = count;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            submit([&task, &remaining, i] {
+                task(i);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+
+        unsigned index = get_worker_index();
+        while (remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (!try_run_one(index))
+                std::this_thread::yield();
+        }
+    }
+
+    ThreadPool& ThreadPool::get_shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::worker_loop(unsigned index)
+    {
+        current_pool = this;
+        current_worker_index = index;
+
+        while (true)
+        {
+            if (try_run_one(index))
+                continue;
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake_condition.wait(lock, [this] {
+                return is_stopping || pending_count.load(std::memory_order_acquire) > 0;
+            });
+            if (is_stopping && pending_count.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+    bool ThreadPool::try_run_one(unsigned index)
+    {
+        Task task;
+        unsigned thread_count = get_thread_count();
+
+        /* Own queue first, newest task. */
+        if (index < thread_count)
+        {
+            WorkerQueue& queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+        }
+
+        /* Then steal the oldest task of another worker. */
+        for (unsigned offset = 1; !task && offset <= thread_count; ++offset)
+        {
+            WorkerQueue& queue = *queues[(index + offset) % thread_count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+
+        if (!task)
+            return false;
+
+        pending_count.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+}
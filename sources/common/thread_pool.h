@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pf
+{
+    /*
+     * Work-stealing thread pool. Every worker owns a task queue: it pops its own newest task
+     * first and steals the oldest task of another worker when it runs dry. Tasks submitted
+     * from inside a worker go to that worker's queue, so nested work stays cache local.
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        /* Create `thread_count` workers, or one per hardware thread when 0. */
+        explicit ThreadPool(unsigned thread_count = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned get_thread_count() const { return static_cast<unsigned>(threads.size()); }
+
+        /*
+         * Index of the calling thread in [0, get_thread_count()], stable for the thread's
+         * lifetime. Threads that are not workers of this pool all share the last index.
+         * Useful to address per-thread scratch buffers.
+         */
+        unsigned get_worker_index() const;
+
+        /* Queue a task for asynchronous execution. */
+        void submit(Task task);
+
+        /*
+         * Call task(i) for every i in [0, count) and block until all calls returned. The
+         * calling thread runs tasks too while it waits, so this may be nested.
+         */
+        void parallel_for(size_t count, const std::function<void(size_t)>& task);
+
+        /* Process wide pool, created on first use. */
+        static ThreadPool& get_shared();
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void worker_loop(unsigned index);
+        bool try_run_one(unsigned index);
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> threads;
+
+        std::mutex sleep_mutex;
+        std::condition_variable wake_condition;
+        std::atomic<size_t> pending_count = 0;
+        std::atomic<unsigned> next_queue = 0;
+        bool is_stopping = false;
+    };
+}
@@ -0,0 +1,68 @@
+#include "binary_font_data.h"
+
+#include <algorithm>
+
+namespace pf
+{
+    bool BinaryFontData::load(pf_io::BinaryReader& reader)
+    {
+        uint32_t count = reader.read_uint32();
+        uint32_t data_size = reader.read_uint32();
+        if (!reader.is_ok())
+            return false;
+
+        if (reader.can_view<FontCharacterInfo>())
+        {
+            font_info_storage.clear();
+            font_info_list = reader.read_span<FontCharacterInfo>(count);
+        }
+        else
+        {
+            if (count > reader.get_remaining() / sizeof(FontCharacterInfo))
+                return false;
+
+            font_info_storage.resize(count);
+            for (FontCharacterInfo& info : font_info_storage)
+            {
+                info.codepoint = reader.read_uint32();
+                info.offset = reader.read_uint32();
+                info.width = reader.read_uint8();
+                info.height = reader.read_uint8();
+                info.reserved = reader.read_uint16();
+            }
+            font_info_list = font_info_storage;
+        }
+        font_data = reader.read_bytes(data_size);
+        if (!reader.is_ok())
+            return false;
+
+        line_height = 0;
+        for (const FontCharacterInfo& info : font_info_list)
+        {
+            size_t size = (static_cast<size_t>(info.width) * info.height + 7) / 8;
+            if (info.offset > font_data.size() || size > font_data.size() - info.offset)
+                return false;
+            line_height = std::max<int>(line_height, info.height);
+        }
+
+        owner = reader.get_owner();
+        return true;
+    }
+
+    int BinaryFontData::find_character(uint32_t codepoint) const
+    {
+        auto it = std::lower_bound(font_info_list.begin(), font_info_list.end(), codepoint,
+            [](const FontCharacterInfo& info, uint32_t value) { return info.codepoint < value; });
+        if (it == font_info_list.end() || it->codepoint != codepoint)
+            return -1;
+        return static_cast<int>(it - font_info_list.begin());
+    }
+
+    const uint8_t* BinaryFontData::get_font_data(int index, int& out_width, int& out_height) const
+    {
+        const FontCharacterInfo& info = font_info_list[index];
+        out_width = info.width;
+        out_height = info.height;
+        return font_data.data() + info.offset;
+    }
+}
@@ -1,23 +1,68 @@
-#include <fstream>
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
+#include "io/binary_reader.h"
+
 namespace pf
 {
-    class FontCharacterInfo
+    /* One character of a font pack, laid out as in the file. */
+    struct FontCharacterInfo
     {
+        uint32_t codepoint;
+        /* Byte offset of the character's bits from the start of the bitmap block. */
         uint32_t offset;
         uint8_t width;
         uint8_t height;
+        uint16_t reserved;
     };
 
-    class BinaryTextData
+    static_assert(sizeof(FontCharacterInfo) == 12);
+
+    /*
+     * Bitmap font written by tools/resource_packer/text_packer.py. Little endian:
+     *
+     *   uint32 character count
+     *   uint32 bitmap block size in bytes
+     *   FontCharacterInfo[character count], sorted by codepoint
+     *   bitmap block: 1 bit per pixel, rows top to bottom, most significant bit first;
+     *   every character starts on a byte boundary
+     *
+     * Loaded from a mapped file, the table and the bitmaps are used in place and stay valid
+     * as long as the font does; only a big endian host copies the table.
+     */
+    class BinaryFontData
     {
     public:
-        void load(std::ifstream file_stream);
-        uint8_t* get_font_data(int index, int& out_width, int& out_height);
+        BinaryFontData() = default;
+        BinaryFontData(const BinaryFontData&) = delete;
+        BinaryFontData& operator=(const BinaryFontData&) = delete;
+        BinaryFontData(BinaryFontData&&) = default;
+        BinaryFontData& operator=(BinaryFontData&&) = default;
+
+        /* Read a font at the reader's position. False if the data is truncated or inconsistent. */
+        bool load(pf_io::BinaryReader& reader);
+
+        int get_character_count() const { return static_cast<int>(font_info_list.size()); }
+        const FontCharacterInfo& get_character_info(int index) const { return font_info_list[index]; }
+
+        /* Height of the tallest character, the distance between two lines of text. */
+        int get_line_height() const { return line_height; }
+
+        /* Index of the character of `codepoint`, or -1 when the font does not have it. */
+        int find_character(uint32_t codepoint) const;
+
+        /* Bits of character `index`, see the format above. */
+        const uint8_t* get_font_data(int index, int& out_width, int& out_height) const;
 
     private:
-        std::vector<FontCharacterInfo> font_info_list;
-        std::vector<uint8_t> font_data;
+        std::shared_ptr<const void> owner;
+        std::span<const FontCharacterInfo> font_info_list;
+        std::vector<FontCharacterInfo> font_info_storage;
+        std::span<const uint8_t> font_data;
+        int line_height = 0;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,47 @@
+#include "binary_text_data.h"
+
+namespace pf
+{
+    bool BinaryTextData::load(pf_io::BinaryReader& reader)
+    {
+        uint32_t language_count = reader.read_uint32();
+        uint32_t string_count = reader.read_uint32();
+        uint32_t pool_size = reader.read_uint32();
+        if (!reader.is_ok() || language_count != TEXT_LANGUAGE_COUNT || string_count != TEXT_ID_COUNT)
+            return false;
+
+        size_t entry_count = static_cast<size_t>(language_count) * string_count;
+        if (reader.can_view<TextEntry>())
+        {
+            text_entry_storage.clear();
+            text_entries = reader.read_span<TextEntry>(entry_count);
+        }
+        else
+        {
+            if (entry_count > reader.get_remaining() / sizeof(TextEntry))
+                return false;
+
+            text_entry_storage.resize(entry_count);
+            for (TextEntry& entry : text_entry_storage)
+            {
+                entry.offset = reader.read_uint32();
+                entry.length = reader.read_uint32();
+            }
+            text_entries = text_entry_storage;
+        }
+        string_pool = reader.read_bytes(pool_size);
+        if (!reader.is_ok())
+            return false;
+
+        /* Every string must end inside the pool with its NUL. */
+        for (const TextEntry& entry : text_entries)
+        {
+            if (entry.offset >= string_pool.size() || entry.length >= string_pool.size() - entry.offset ||
+                string_pool[entry.offset + entry.length] != 0)
+                return false;
+        }
+
+        owner = reader.get_owner();
+        return true;
+    }
+}
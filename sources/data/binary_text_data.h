@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "define/text_id.generated.h"
+#include "io/binary_reader.h"
+
+namespace pf
+{
+    /* Where a string lies in the pool, laid out as in the file. */
+    struct TextEntry
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    static_assert(sizeof(TextEntry) == 8);
+
+    /*
+     * Text table written by tools/resource_packer/text_table_packer.py. Little endian:
+     *
+     *   uint32 language count, uint32 string count, uint32 string pool size
+     *   TextEntry[language count * string count], language major, in TextId order
+     *   string pool: UTF-8, every string followed by a NUL
+     *
+     * Strings are looked up by TextId, an index into the entries; there is no key, hashing
+     * or allocation at run time. Loaded from a mapped file, the entries and the pool are used
+     * in place, so get_text() returns views into the mapping that stay valid as long as the
+     * table does.
+     */
+    class BinaryTextData
+    {
+    public:
+        BinaryTextData() = default;
+        BinaryTextData(const BinaryTextData&) = delete;
+        BinaryTextData& operator=(const BinaryTextData&) = delete;
+        BinaryTextData(BinaryTextData&&) = default;
+        BinaryTextData& operator=(BinaryTextData&&) = default;
+
+        /*
+         * Read a table at the reader's position. False if the data is truncated or inconsistent,
+         * or does not have the languages and ids of text_id.generated.h.
+         */
+        bool load(pf_io::BinaryReader& reader);
+
+        TextLanguage get_language() const { return language; }
+        void set_language(TextLanguage value) { language = value; }
+
+        /* Text `id` in the current language. The view is also NUL terminated. */
+        std::string_view get_text(TextId id) const { return get_text(id, language); }
+
+        std::string_view get_text(TextId id, TextLanguage text_language) const
+        {
+            assert(!text_entries.empty());
+            const TextEntry& entry = text_entries[static_cast<size_t>(text_language) * TEXT_ID_COUNT + static_cast<size_t>(id)];
+            return std::string_view(reinterpret_cast<const char*>(string_pool.data()) + entry.offset, entry.length);
+        }
+
+    private:
+        std::shared_ptr<const void> owner;
+        std::span<const TextEntry> text_entries;
+        std::vector<TextEntry> text_entry_storage;
+        std::span<const uint8_t> string_pool;
+        TextLanguage language = TextLanguage(0);
+    };
+}
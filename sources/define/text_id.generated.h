@@ -1,4 +1,64 @@
+/* Generated by tools/resource_packer, do not edit. */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
 namespace pf
 {
+	enum class TextId : uint16_t
+	{
+		RANK_A = 0,
+		RANK_2 = 1,
+		RANK_3 = 2,
+		RANK_4 = 3,
+		RANK_5 = 4,
+		RANK_6 = 5,
+		RANK_7 = 6,
+		RANK_8 = 7,
+		RANK_9 = 8,
+		RANK_10 = 9,
+		RANK_J = 10,
+		RANK_Q = 11,
+		RANK_K = 12,
+		RANK_JOKER = 13,
+	};
+
+	enum class TextLanguage : uint8_t
+	{
+		ZH_CN = 0,
+	};
+
+	constexpr uint32_t TEXT_ID_COUNT = 14;
+
+	constexpr std::string_view TEXT_KEYS[] = { "RANK_A", "RANK_2", "RANK_3", "RANK_4", "RANK_5", "RANK_6", "RANK_7", "RANK_8", "RANK_9", "RANK_10", "RANK_J", "RANK_Q", "RANK_K", "RANK_JOKER" };
+
+	constexpr int32_t TEXT_KEY_SEEDS[] = { 0, 0, 8, 0, -10, 0, 0, -4, 1, 0, 7, 4, -1, 0 };
+
+	constexpr uint16_t TEXT_KEY_SLOTS[] = { 12, 8, 6, 4, 9, 2, 11, 5, 0, 10, 13, 1, 7, 3 };
+
+	constexpr uint32_t TEXT_LANGUAGE_COUNT = 1;
+
+	constexpr uint32_t hash_text_key(std::string_view key, uint32_t seed)
+	{
+		uint32_t value = 0x811c9dc5u ^ seed;
+		for (char c : key)
+			value = (value ^ static_cast<uint8_t>(c)) * 0x01000193u;
+		value = (value ^ value >> 16) * 0x85ebca6bu;
+		value = (value ^ value >> 13) * 0xc2b2ae35u;
+		return value ^ value >> 16;
+	}
 
-}
\ No newline at end of file
+	constexpr std::optional<TextId> find_text_id(std::string_view key)
+	{
+		/* Minimal perfect hash generated by tools/resource_packer/text_table_packer.py. */
+		int32_t seed = TEXT_KEY_SEEDS[hash_text_key(key, 0) % TEXT_ID_COUNT];
+		uint32_t slot = seed < 0 ? static_cast<uint32_t>(-seed - 1) : hash_text_key(key, static_cast<uint32_t>(seed)) % TEXT_ID_COUNT;
+		uint16_t id = TEXT_KEY_SLOTS[slot];
+		if (TEXT_KEYS[id] != key)
+			return std::nullopt;
+		return static_cast<TextId>(id);
+	}
+}
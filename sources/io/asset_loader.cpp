@@ -0,0 +1,78 @@
+#include "asset_loader.h"
+
+#include <utility>
+
+namespace pf_io
+{
+    AssetLoader::AssetLoader(std::shared_ptr<const PackReader> pack, unsigned thread_count) :
+        pack(std::move(pack))
+    {
+        if (thread_count == 0)
+            thread_count = 1;
+        for (unsigned i = 0; i < thread_count; ++i)
+            threads.emplace_back([this] { worker_loop(); });
+    }
+
+    AssetLoader::~AssetLoader()
+    {
+        {
+            std::lock_guard lock(mutex);
+            is_stopping = true;
+        }
+        wake_condition.notify_all();
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    void AssetLoader::enqueue(int priority, Job job)
+    {
+        {
+            std::lock_guard lock(mutex);
+            requests.push(Request{ priority, next_sequence++, std::move(job) });
+        }
+        wake_condition.notify_one();
+    }
+
+    void AssetLoader::worker_loop()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                wake_condition.wait(lock, [this] { return is_stopping || !requests.empty(); });
+                if (is_stopping)
+                    return;
+
+                job = std::move(const_cast<Request&>(requests.top()).job);
+                requests.pop();
+                ++running_count;
+            }
+
+            Completion completion = job();
+
+            std::lock_guard lock(mutex);
+            if (completion)
+                completions.push_back(std::move(completion));
+            --running_count;
+        }
+    }
+
+    void AssetLoader::pump()
+    {
+        std::vector<Completion> finished;
+        {
+            std::lock_guard lock(mutex);
+            finished.swap(completions);
+        }
+
+        for (Completion& completion : finished)
+            completion();
+    }
+
+    bool AssetLoader::is_idle() const
+    {
+        std::lock_guard lock(mutex);
+        return requests.empty() && running_count == 0 && completions.empty();
+    }
+}
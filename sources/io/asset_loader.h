@@ -0,0 +1,151 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "io/binary_reader.h"
+#include "io/pack_reader.h"
+
+namespace pf_io
+{
+    enum class AssetState
+    {
+        Pending,
+        Ready,
+        Failed,
+    };
+
+    /*
+     * Result of an AssetLoader request, shared between the loader and whoever asked. The
+     * state and the asset change only inside AssetLoader::pump(), so on the thread that pumps
+     * they never change under the reader's feet. A request whose handles are all dropped
+     * before it starts is skipped.
+     */
+    template<typename T>
+    class AssetHandle
+    {
+    public:
+        AssetHandle() = default;
+
+        bool is_valid() const { return slot != nullptr; }
+        AssetState get_state() const { return slot ? slot->state : AssetState::Failed; }
+        bool is_ready() const { return get_state() == AssetState::Ready; }
+
+        /* The asset once ready, null before. */
+        const T* get() const { return is_ready() ? slot->asset.get() : nullptr; }
+
+    private:
+        friend class AssetLoader;
+
+        struct Slot
+        {
+            AssetState state = AssetState::Pending;
+            std::shared_ptr<const T> asset;
+        };
+
+        explicit AssetHandle(std::shared_ptr<Slot> slot) : slot(std::move(slot)) {}
+
+        std::shared_ptr<Slot> slot;
+    };
+
+    /*
+     * Loads resources of a pack in the background. Requests run on the loader's own threads,
+     * highest priority first and in request order within a priority, and do both the I/O
+     * and the decode there. Finished assets are handed over by pump(), which the main thread
+     * calls once per frame at a point where nothing uses them.
+     */
+    class AssetLoader
+    {
+    public:
+        /* Fills an asset from a reader over its resource; false when the data is unusable. */
+        template<typename T>
+        using Decoder = std::function<bool(BinaryReader& reader, T& out_asset)>;
+
+        AssetLoader(std::shared_ptr<const PackReader> pack, unsigned thread_count = 1);
+        ~AssetLoader();
+
+        AssetLoader(const AssetLoader&) = delete;
+        AssetLoader& operator=(const AssetLoader&) = delete;
+
+        /*
+         * Queue resource `name` to be decoded into a T. `on_ready`, if any, is called from
+         * pump() once the asset is ready or has failed.
+         */
+        template<typename T>
+        AssetHandle<T> load(std::string_view name, int priority, Decoder<T> decoder,
+            std::function<void(const AssetHandle<T>&)> on_ready = nullptr)
+        {
+            auto slot = std::make_shared<typename AssetHandle<T>::Slot>();
+            std::weak_ptr<typename AssetHandle<T>::Slot> weak_slot = slot;
+            uint64_t id = hash_resource_name(name);
+
+            enqueue(priority, [this, weak_slot, id, decoder = std::move(decoder), on_ready = std::move(on_ready)]() -> Completion {
+                if (weak_slot.expired())
+                    return nullptr;
+
+                auto asset = std::make_shared<T>();
+                BinaryReader reader = pack->open(id);
+                bool is_ok = pack->contains(id) && decoder(reader, *asset);
+
+                return [weak_slot, is_ok, asset, on_ready]() {
+                    auto slot = weak_slot.lock();
+                    if (!slot)
+                        return;
+                    slot->state = is_ok ? AssetState::Ready : AssetState::Failed;
+                    if (is_ok)
+                        slot->asset = asset;
+                    if (on_ready)
+                        on_ready(AssetHandle<T>(slot));
+                };
+            });
+            return AssetHandle<T>(std::move(slot));
+        }
+
+        /* Publish the assets finished since the last call. Call from the main thread only. */
+        void pump();
+
+        /* True when no request is queued, running or waiting for pump(). */
+        bool is_idle() const;
+
+    private:
+        /* Runs on the main thread in pump(). */
+        using Completion = std::function<void()>;
+        /* Runs on a loader thread. */
+        using Job = std::function<Completion()>;
+
+        struct Request
+        {
+            int priority;
+            uint64_t sequence;
+            Job job;
+
+            bool operator<(const Request& other) const
+            {
+                if (priority != other.priority)
+                    return priority < other.priority;
+                return sequence > other.sequence;
+            }
+        };
+
+        void enqueue(int priority, Job job);
+        void worker_loop();
+
+        std::shared_ptr<const PackReader> pack;
+        std::vector<std::thread> threads;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake_condition;
+        std::priority_queue<Request> requests;
+        std::vector<Completion> completions;
+        uint64_t next_sequence = 0;
+        int running_count = 0;
+        bool is_stopping = false;
+    };
+}
@@ -1,5 +1,8 @@
 #include "binary_reader.h"
 
+#include <cstring>
+#include <utility>
+
 namespace pf_io
 {
     static Endian get_endian()
@@ -10,47 +13,106 @@ namespace pf_io
     }
 
     BinaryReader::BinaryReader(std::string filename, Endian endian):
-        file_stream(filename, std::ios::binary),
+        BinaryReader(std::make_shared<const MappedFile>(filename), endian)
+    {}
+
+    BinaryReader::BinaryReader(std::shared_ptr<const MappedFile> mapping, Endian endian):
+        owner(mapping),
+        data(mapping->get_data()),
+        is_endian_different(endian != Endian::Native && endian != get_endian()),
+        is_failed(!mapping->is_open())
+    {}
+
+    BinaryReader::BinaryReader(std::span<const uint8_t> data, Endian endian):
+        data(data),
         is_endian_different(endian != Endian::Native && endian != get_endian())
     {}
 
-    BinaryReader::~BinaryReader()
+    BinaryReader::BinaryReader(std::shared_ptr<const void> owner, std::span<const uint8_t> data, Endian endian):
+        owner(std::move(owner)),
+        data(data),
+        is_endian_different(endian != Endian::Native && endian != get_endian())
+    {}
+
+    BinaryReader::~BinaryReader() = default;
+
+    const uint8_t* BinaryReader::take(size_t count)
     {
-        file_stream.close();
+        if (is_failed || count > data.size() - position)
+        {
+            is_failed = true;
+            position = data.size();
+            return nullptr;
+        }
+
+        const uint8_t* bytes = data.data() + position;
+        position += count;
+        return bytes;
     }
 
     uint32_t BinaryReader::read_uint32()
     {
-        uint8_t bytes[4];
-        file_stream.read(reinterpret_cast<char*>(bytes), 4);
+        const uint8_t* bytes = take(4);
+        if (!bytes)
+            return 0;
+
         if (is_endian_different)
         {
-            return bytes[3] | (bytes[2] << 8) | (bytes[1] << 16) | (bytes[0] << 32);
+            return static_cast<uint32_t>(bytes[3]) | (static_cast<uint32_t>(bytes[2]) << 8) |
+                (static_cast<uint32_t>(bytes[1]) << 16) | (static_cast<uint32_t>(bytes[0]) << 24);
         }
         else
         {
-            return *reinterpret_cast<uint32_t*>(&bytes);
+            uint32_t value;
+            std::memcpy(&value, bytes, 4);
+            return value;
         }
     }
 
     uint16_t BinaryReader::read_uint16()
     {
-        uint8_t bytes[2];
-        file_stream.read(reinterpret_cast<char*>(bytes), 2);
+        const uint8_t* bytes = take(2);
+        if (!bytes)
+            return 0;
+
         if (is_endian_different)
         {
-            return bytes[1] | (bytes[0] << 8);
+            return static_cast<uint16_t>(bytes[1] | (bytes[0] << 8));
         }
         else
         {
-            return *reinterpret_cast<uint16_t*>(&bytes);
+            uint16_t value;
+            std::memcpy(&value, bytes, 2);
+            return value;
         }
     }
 
     uint8_t BinaryReader::read_uint8()
     {
-        uint8_t byte;
-        file_stream.read(reinterpret_cast<char*>(&byte), 1);
-        return byte;
+        const uint8_t* bytes = take(1);
+        return bytes ? *bytes : 0;
+    }
+
+    std::span<const uint8_t> BinaryReader::read_bytes(size_t count)
+    {
+        const uint8_t* bytes = take(count);
+        if (!bytes)
+            return {};
+        return { bytes, count };
+    }
+
+    void BinaryReader::skip(size_t count)
+    {
+        take(count);
+    }
+
+    void BinaryReader::seek(size_t position)
+    {
+        if (position > data.size())
+        {
+            is_failed = true;
+            position = data.size();
+        }
+        this->position = position;
     }
 }
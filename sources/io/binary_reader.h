@@ -1,6 +1,16 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
 #include <string>
-#include <fstream>
+#include <type_traits>
+
+#include "io/byte_swap.h"
+#include "io/mapped_file.h"
 
 namespace pf_io
 {
@@ -17,18 +27,124 @@ namespace pf_io
 #endif
     };
 
+    /*
+     * Sequential reader over a byte span: a memory-mapped file or a buffer owned by someone
+     * else. Every read is bounds checked. A read past the end returns zeros or an empty view,
+     * and leaves the reader failed, so a whole record can be read and checked once.
+     *
+     * read_bytes() and read_span() return views into the source instead of copies. They stay
+     * valid as long as the source's owner lives: the mapping of a file, or whatever object
+     * was passed as owner, see get_owner().
+     */
     class BinaryReader
     {
     public:
+        /* Map `filename`. is_ok() is false when it cannot be opened. */
         BinaryReader(std::string filename, Endian endian=Endian::Native);
+        /* Read all of `mapping`. */
+        BinaryReader(std::shared_ptr<const MappedFile> mapping, Endian endian=Endian::Native);
+        /* Read `data`, which must outlive the reader and every view taken from it. */
+        BinaryReader(std::span<const uint8_t> data, Endian endian=Endian::Native);
+        /* Read `data`, memory held by `owner`, e.g. a part of a MappedFile. The reader shares the ownership. */
+        BinaryReader(std::shared_ptr<const void> owner, std::span<const uint8_t> data, Endian endian=Endian::Native);
         ~BinaryReader();
 
+        /* False once the source could not be opened or a read ran past the end. */
+        bool is_ok() const { return !is_failed; }
+
+        size_t get_size() const { return data.size(); }
+        size_t get_position() const { return position; }
+        size_t get_remaining() const { return data.size() - position; }
+
+        /* Owner of the memory behind the views, null for a plain buffer. Keep it to keep the views alive. */
+        const std::shared_ptr<const void>& get_owner() const { return owner; }
+
         uint32_t read_uint32();
         uint16_t read_uint16();
         uint8_t read_uint8();
 
+        /*
+         * Fill `out_values` with the next values, converted to host byte order. Integers and
+         * floating point values of 1, 2, 4 or 8 bytes. A swapping read runs at memory speed,
+         * see copy_byte_swapped(). On failure the values are zeroed and false is returned.
+         */
+        template<typename T>
+        bool read_array(std::span<T> out_values)
+        {
+            return read_array_as(out_values, is_endian_different);
+        }
+
+        /*
+         * Same with the byte order of the data fixed at compile time, ignoring the reader's:
+         * a plain memcpy when FileEndian is the host's.
+         */
+        template<Endian FileEndian, typename T>
+        bool read_array(std::span<T> out_values)
+        {
+            return read_array_as(out_values, std::bool_constant<FileEndian != Endian::Native>());
+        }
+
+        /* View of the next `count` bytes. */
+        std::span<const uint8_t> read_bytes(size_t count);
+
+        /*
+         * View of the next `count` values of T stored as they are in memory. Fails unless the
+         * data has native byte order or T is a single byte, and the position is aligned for T.
+         */
+        template<typename T>
+        std::span<const T> read_span(size_t count)
+        {
+            if (!can_view<T>() || count > get_remaining() / sizeof(T))
+            {
+                is_failed = true;
+                position = data.size();
+                return {};
+            }
+
+            std::span<const uint8_t> bytes = read_bytes(count * sizeof(T));
+            return { reinterpret_cast<const T*>(bytes.data()), count };
+        }
+
+        /* Whether read_span<T>() is possible at the current position, size aside. */
+        template<typename T>
+        bool can_view() const
+        {
+            return !(is_endian_different && sizeof(T) > 1) &&
+                reinterpret_cast<uintptr_t>(data.data() + position) % alignof(T) == 0;
+        }
+
+        /* Skip `count` bytes. */
+        void skip(size_t count);
+
+        /* Continue reading at `position` from the start. Seeking past the end fails the reader. */
+        void seek(size_t position);
+
     private:
+        const uint8_t* take(size_t count);
+
+        template<typename T, typename SwapFlag>
+        bool read_array_as(std::span<T> out_values, SwapFlag is_swapped)
+        {
+            static_assert(std::is_arithmetic_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8));
+
+            const uint8_t* bytes = take(out_values.size_bytes());
+            if (!bytes)
+            {
+                std::fill(out_values.begin(), out_values.end(), T());
+                return false;
+            }
+
+            if (sizeof(T) > 1 && is_swapped)
+                copy_byte_swapped(bytes, out_values.data(), out_values.size(), sizeof(T));
+            else
+                std::memcpy(out_values.data(), bytes, out_values.size_bytes());
+            return true;
+        }
+
+        std::shared_ptr<const void> owner;
+        std::span<const uint8_t> data;
+        size_t position = 0;
         bool is_endian_different;
-        std::ifstream file_stream;
+        bool is_failed = false;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,141 @@
+#include "byte_swap.h"
+
+#include <cassert>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace pf_io
+{
+    namespace
+    {
+        uint16_t swap16(uint16_t value)
+        {
+            return static_cast<uint16_t>(value << 8 | value >> 8);
+        }
+
+        uint32_t swap32(uint32_t value)
+        {
+            return (value << 24) | ((value << 8) & 0x00ff0000u) | ((value >> 8) & 0x0000ff00u) | (value >> 24);
+        }
+
+        uint64_t swap64(uint64_t value)
+        {
+            return uint64_t(swap32(static_cast<uint32_t>(value))) << 32 | swap32(static_cast<uint32_t>(value >> 32));
+        }
+
+        /* Scalar tail, also the whole loop on targets without SIMD. */
+        template<typename T, T (*Swap)(T)>
+        void copy_swapped_scalar(const uint8_t* source, uint8_t* destination, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                T value;
+                std::memcpy(&value, source + i * sizeof(T), sizeof(T));
+                value = Swap(value);
+                std::memcpy(destination + i * sizeof(T), &value, sizeof(T));
+            }
+        }
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+        /* Byte shuffle reversing every element of `ElementSize` bytes in a 16-byte lane. */
+        template<size_t ElementSize>
+        __m128i get_swap_mask()
+        {
+            alignas(16) uint8_t mask[16];
+            for (size_t i = 0; i < 16; ++i)
+                mask[i] = static_cast<uint8_t>(i - i % ElementSize + ElementSize - 1 - i % ElementSize);
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+        }
+#endif
+
+        /* Swap the whole 16 or 32 byte blocks and return how many bytes were done. */
+        template<size_t ElementSize>
+        size_t copy_swapped_simd(const uint8_t* source, uint8_t* destination, size_t size)
+        {
+            size_t done = 0;
+#if defined(__AVX2__)
+            __m128i lane_mask = get_swap_mask<ElementSize>();
+            __m256i mask = _mm256_broadcastsi128_si256(lane_mask);
+            for (; done + 32 <= size; done += 32)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + done));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + done), _mm256_shuffle_epi8(block, mask));
+            }
+            for (; done + 16 <= size; done += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + done));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + done), _mm_shuffle_epi8(block, lane_mask));
+            }
+#elif defined(__SSSE3__)
+            __m128i mask = get_swap_mask<ElementSize>();
+            for (; done + 16 <= size; done += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + done));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + done), _mm_shuffle_epi8(block, mask));
+            }
+#elif defined(__SSE2__) || defined(_M_X64)
+            /* No byte shuffle: swap the bytes of 16-bit words, then the words themselves. */
+            for (; done + 16 <= size; done += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + done));
+                block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+                if constexpr (ElementSize == 4)
+                {
+                    block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+                    block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+                }
+                else if constexpr (ElementSize == 8)
+                {
+                    block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(0, 1, 2, 3));
+                    block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(0, 1, 2, 3));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + done), block);
+            }
+#else
+            (void)source;
+            (void)destination;
+            (void)size;
+#endif
+            return done;
+        }
+    }
+
+    void copy_byte_swapped(const uint8_t* source, void* destination, size_t count, size_t element_size)
+    {
+        uint8_t* out = static_cast<uint8_t*>(destination);
+        size_t size = count * element_size;
+
+        switch (element_size)
+        {
+        case 2:
+        {
+            size_t done = copy_swapped_simd<2>(source, out, size);
+            copy_swapped_scalar<uint16_t, swap16>(source + done, out + done, (size - done) / 2);
+            break;
+        }
+        case 4:
+        {
+            size_t done = copy_swapped_simd<4>(source, out, size);
+            copy_swapped_scalar<uint32_t, swap32>(source + done, out + done, (size - done) / 4);
+            break;
+        }
+        case 8:
+        {
+            size_t done = copy_swapped_simd<8>(source, out, size);
+            copy_swapped_scalar<uint64_t, swap64>(source + done, out + done, (size - done) / 8);
+            break;
+        }
+        default:
+            assert(element_size == 1);
+            std::memcpy(out, source, size);
+            break;
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pf_io
+{
+    /*
+     * Copy `count` elements of `element_size` bytes (2, 4 or 8) from `source` to `destination`,
+     * reversing the bytes of every element. Unaligned buffers are fine; they must not overlap.
+     * Uses AVX2 or SSE when the build targets them and a scalar loop otherwise.
+     */
+    void copy_byte_swapped(const uint8_t* source, void* destination, size_t count, size_t element_size);
+}
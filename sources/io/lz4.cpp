@@ -0,0 +1,94 @@
+#include "lz4.h"
+
+#include <cstring>
+
+namespace pf_io
+{
+    namespace
+    {
+        constexpr size_t MIN_MATCH = 4;
+
+        /* Add the 255-terminated extension bytes of a 15 length. False when the input runs out. */
+        bool read_length(const uint8_t*& in, const uint8_t* in_end, size_t& length)
+        {
+            if (length != 15)
+                return true;
+
+            uint8_t byte;
+            do
+            {
+                if (in == in_end)
+                    return false;
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+    }
+
+    bool decompress_lz4_block(std::span<const uint8_t> source, std::span<uint8_t> destination)
+    {
+        const uint8_t* in = source.data();
+        const uint8_t* in_end = in + source.size();
+        uint8_t* out = destination.data();
+        uint8_t* out_begin = out;
+        uint8_t* out_end = out + destination.size();
+
+        while (in < in_end)
+        {
+            uint8_t token = *in++;
+
+            size_t literal_length = token >> 4;
+            if (!read_length(in, in_end, literal_length))
+                return false;
+            if (literal_length > static_cast<size_t>(in_end - in) || literal_length > static_cast<size_t>(out_end - out))
+                return false;
+            std::memcpy(out, in, literal_length);
+            in += literal_length;
+            out += literal_length;
+
+            /* The last sequence has literals only. */
+            if (in == in_end)
+                break;
+
+            if (in_end - in < 2)
+                return false;
+            size_t offset = in[0] | in[1] << 8;
+            in += 2;
+            if (offset == 0 || offset > static_cast<size_t>(out - out_begin))
+                return false;
+
+            size_t match_length = token & 15;
+            if (!read_length(in, in_end, match_length))
+                return false;
+            match_length += MIN_MATCH;
+            if (match_length > static_cast<size_t>(out_end - out))
+                return false;
+
+            const uint8_t* match = out - offset;
+            if (offset >= match_length)
+            {
+                std::memcpy(out, match, match_length);
+                out += match_length;
+            }
+            else if (offset >= 8)
+            {
+                /* Overlapping but at least 8 apart: 8-byte steps never read unwritten bytes. */
+                uint8_t* match_end = out + match_length;
+                for (; match_end - out >= 8; out += 8, match += 8)
+                    std::memcpy(out, match, 8);
+                while (out < match_end)
+                    *out++ = *match++;
+            }
+            else
+            {
+                /* Short repeat period, e.g. runs of one byte. */
+                for (size_t i = 0; i < match_length; ++i)
+                    out[i] = match[i];
+                out += match_length;
+            }
+        }
+
+        return out == out_end;
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace pf_io
+{
+    /*
+     * Decode one LZ4 block into `destination`, which must be exactly the decoded size. Every
+     * read and write is bounds checked, so corrupt input fails instead of overrunning.
+     * Returns false unless the block decodes to exactly destination.size() bytes.
+     */
+    bool decompress_lz4_block(std::span<const uint8_t> source, std::span<uint8_t> destination);
+}
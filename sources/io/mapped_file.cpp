@@ -0,0 +1,138 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pf_io
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& filename)
+    {
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        if (file_size.QuadPart == 0)
+        {
+            is_mapped = true;
+        }
+        else if (file_size.QuadPart > 0)
+        {
+            mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_handle)
+            {
+                data = static_cast<const uint8_t*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+                if (data)
+                {
+                    size = static_cast<size_t>(file_size.QuadPart);
+                    is_mapped = true;
+                }
+                else
+                {
+                    CloseHandle(mapping_handle);
+                    mapping_handle = nullptr;
+                }
+            }
+        }
+
+        /* The mapping keeps the file open. */
+        CloseHandle(file);
+    }
+
+    void MappedFile::close()
+    {
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping_handle)
+            CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+        data = nullptr;
+        size = 0;
+        is_mapped = false;
+    }
+#else
+    MappedFile::MappedFile(const std::string& filename)
+    {
+        int file = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+            return;
+
+        struct stat file_stat;
+        if (fstat(file, &file_stat) != 0)
+        {
+            ::close(file);
+            return;
+        }
+
+        if (file_stat.st_size == 0)
+        {
+            is_mapped = true;
+        }
+        else if (file_stat.st_size > 0)
+        {
+            void* address = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if (address != MAP_FAILED)
+            {
+                data = static_cast<const uint8_t*>(address);
+                size = static_cast<size_t>(file_stat.st_size);
+                is_mapped = true;
+            }
+        }
+
+        /* The mapping keeps the file open. */
+        ::close(file);
+    }
+
+    void MappedFile::close()
+    {
+        if (data)
+            munmap(const_cast<uint8_t*>(data), size);
+        data = nullptr;
+        size = 0;
+        is_mapped = false;
+    }
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            data = std::exchange(other.data, nullptr);
+            size = std::exchange(other.size, 0);
+            is_mapped = std::exchange(other.is_mapped, false);
+#ifdef _WIN32
+            mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+        }
+        return *this;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace pf_io
+{
+    /*
+     * Read-only memory mapping of a whole file. The pages are loaded by the OS on first
+     * touch and shared with the page cache, so large packs cost neither a copy nor resident
+     * memory for the parts that are never read.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /* False when the file could not be opened or mapped. An empty file is open with no data. */
+        bool is_open() const { return is_mapped; }
+
+        std::span<const uint8_t> get_data() const { return { data, size }; }
+        size_t get_size() const { return size; }
+
+    private:
+        void close();
+
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        bool is_mapped = false;
+#ifdef _WIN32
+        void* mapping_handle = nullptr;
+#endif
+    };
+}
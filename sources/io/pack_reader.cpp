@@ -0,0 +1,198 @@
+#include "pack_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+#include "common/thread_pool.h"
+#include "io/lz4.h"
+
+namespace pf_io
+{
+    namespace
+    {
+        constexpr uint32_t CHUNK_STORED_FLAG = 0x80000000u;
+    }
+
+    PackReader::PackReader(const std::string& filename)
+    {
+        mapping = std::make_shared<const MappedFile>(filename);
+        BinaryReader reader(mapping, Endian::Little);
+        std::span<const uint8_t> magic = reader.read_bytes(4);
+        uint32_t version = reader.read_uint32();
+        uint32_t toc_offset = reader.read_uint32();
+        uint32_t bucket_count = reader.read_uint32();
+        uint32_t count = reader.read_uint32();
+        reader.read_uint32();
+        if (!reader.is_ok() || std::memcmp(magic.data(), "PFPK", 4) != 0 || version != VERSION)
+            return;
+        if (!std::has_single_bit(bucket_count) || count > bucket_count)
+            return;
+
+        reader.seek(toc_offset);
+        if (reader.can_view<PackTocEntry>())
+        {
+            buckets = reader.read_span<PackTocEntry>(bucket_count);
+        }
+        else
+        {
+            if (bucket_count > reader.get_remaining() / sizeof(PackTocEntry))
+                return;
+
+            bucket_storage.resize(bucket_count);
+            for (PackTocEntry& entry : bucket_storage)
+            {
+                uint32_t low = reader.read_uint32();
+                uint32_t high = reader.read_uint32();
+                entry.id = uint64_t(high) << 32 | low;
+                entry.offset = reader.read_uint32();
+                entry.stored_size = reader.read_uint32();
+                entry.size = reader.read_uint32();
+                entry.codec = static_cast<PackCodec>(reader.read_uint16());
+                entry.reserved = reader.read_uint16();
+            }
+            buckets = bucket_storage;
+        }
+        if (!reader.is_ok())
+            return;
+
+        /* Check every blob once so lookups need no bounds checks. */
+        int used_count = 0;
+        for (const PackTocEntry& entry : buckets)
+        {
+            if (entry.id == 0)
+                continue;
+            if (entry.offset > reader.get_size() || entry.stored_size > reader.get_size() - entry.offset)
+                return;
+            if (entry.codec == PackCodec::None ? entry.stored_size != entry.size : entry.codec != PackCodec::Lz4Chunks)
+                return;
+            ++used_count;
+        }
+        if (used_count != static_cast<int>(count) || used_count == static_cast<int>(bucket_count))
+            return;
+
+        resource_count = used_count;
+        is_valid = true;
+    }
+
+    const PackTocEntry* PackReader::find_entry(uint64_t id) const
+    {
+        if (!is_valid || id == 0)
+            return nullptr;
+
+        /* The table always has an empty bucket, so the probe ends. */
+        size_t mask = buckets.size() - 1;
+        for (size_t bucket = id & mask; ; bucket = (bucket + 1) & mask)
+        {
+            const PackTocEntry& entry = buckets[bucket];
+            if (entry.id == id)
+                return &entry;
+            if (entry.id == 0)
+                return nullptr;
+        }
+    }
+
+    size_t PackReader::get_resource_size(uint64_t id) const
+    {
+        const PackTocEntry* entry = find_entry(id);
+        return entry ? entry->size : 0;
+    }
+
+    bool PackReader::is_compressed(uint64_t id) const
+    {
+        const PackTocEntry* entry = find_entry(id);
+        return entry && entry->codec != PackCodec::None;
+    }
+
+    std::span<const uint8_t> PackReader::find(uint64_t id) const
+    {
+        const PackTocEntry* entry = find_entry(id);
+        if (!entry || entry->codec != PackCodec::None)
+            return {};
+        return mapping->get_data().subspan(entry->offset, entry->size);
+    }
+
+    bool PackReader::read(uint64_t id, std::span<uint8_t> out_data, pf::ThreadPool* thread_pool) const
+    {
+        const PackTocEntry* entry = find_entry(id);
+        if (!entry || out_data.size() != entry->size)
+            return false;
+
+        std::span<const uint8_t> stored = mapping->get_data().subspan(entry->offset, entry->stored_size);
+        if (entry->codec == PackCodec::None)
+        {
+            std::copy(stored.begin(), stored.end(), out_data.begin());
+            return true;
+        }
+
+        BinaryReader reader(stored, Endian::Little);
+        uint32_t chunk_size = reader.read_uint32();
+        uint32_t chunk_count = reader.read_uint32();
+        if (!reader.is_ok() || chunk_size == 0 || chunk_count != (uint64_t(entry->size) + chunk_size - 1) / chunk_size)
+            return false;
+
+        /* Chunk table, turned into the start of every chunk's data. */
+        std::vector<uint32_t> chunk_starts(chunk_count + 1);
+        reader.read_array(std::span<uint32_t>(chunk_starts.data(), chunk_count));
+        if (!reader.is_ok())
+            return false;
+
+        std::vector<bool> is_chunk_stored(chunk_count);
+        uint64_t position = reader.get_position();
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            uint32_t size = chunk_starts[i] & ~CHUNK_STORED_FLAG;
+            is_chunk_stored[i] = (chunk_starts[i] & CHUNK_STORED_FLAG) != 0;
+            chunk_starts[i] = static_cast<uint32_t>(position);
+            position += size;
+        }
+        if (position != stored.size())
+            return false;
+        chunk_starts[chunk_count] = static_cast<uint32_t>(position);
+
+        std::atomic<bool> is_ok = true;
+        auto decode_chunk = [&](size_t i) {
+            std::span<const uint8_t> source = stored.subspan(chunk_starts[i], chunk_starts[i + 1] - chunk_starts[i]);
+            size_t begin = i * chunk_size;
+            std::span<uint8_t> destination = out_data.subspan(begin, std::min<size_t>(chunk_size, out_data.size() - begin));
+
+            bool is_chunk_ok;
+            if (is_chunk_stored[i])
+            {
+                is_chunk_ok = source.size() == destination.size();
+                if (is_chunk_ok)
+                    std::memcpy(destination.data(), source.data(), source.size());
+            }
+            else
+            {
+                is_chunk_ok = decompress_lz4_block(source, destination);
+            }
+            if (!is_chunk_ok)
+                is_ok.store(false, std::memory_order_relaxed);
+        };
+
+        if (chunk_count == 1)
+        {
+            decode_chunk(0);
+        }
+        else
+        {
+            pf::ThreadPool& pool = thread_pool ? *thread_pool : pf::ThreadPool::get_shared();
+            pool.parallel_for(chunk_count, decode_chunk);
+        }
+        return is_ok.load(std::memory_order_relaxed);
+    }
+
+    BinaryReader PackReader::open(uint64_t id, pf::ThreadPool* thread_pool) const
+    {
+        const PackTocEntry* entry = find_entry(id);
+        if (!entry || entry->codec == PackCodec::None)
+            return BinaryReader(mapping, find(id), Endian::Little);
+
+        auto buffer = std::make_shared<std::vector<uint8_t>>(entry->size);
+        if (!read(id, *buffer, thread_pool))
+            buffer->clear();
+        return BinaryReader(buffer, *buffer, Endian::Little);
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/binary_reader.h"
+#include "io/mapped_file.h"
+
+namespace pf
+{
+    class ThreadPool;
+}
+
+namespace pf_io
+{
+    /* Resource id of a name: 64-bit FNV-1a of its UTF-8 bytes, as tools/resource_packer/pack_writer.py computes it. */
+    constexpr uint64_t hash_resource_name(std::string_view name)
+    {
+        uint64_t value = 0xcbf29ce484222325ull;
+        for (char c : name)
+            value = (value ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+        return value;
+    }
+
+    enum class PackCodec : uint16_t
+    {
+        None = 0,
+        /* Independently compressed LZ4 chunks, see tools/resource_packer/pack_writer.py. */
+        Lz4Chunks = 1,
+    };
+
+    /* Table of contents bucket, laid out as in the file. Id 0 marks an empty bucket. */
+    struct PackTocEntry
+    {
+        uint64_t id;
+        uint32_t offset;
+        uint32_t stored_size;
+        uint32_t size;
+        PackCodec codec;
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(PackTocEntry) == 24);
+
+    /*
+     * Resource pack written by tools/resource_packer/pack_writer.py, see there for the layout.
+     * The pack is memory-mapped and its table of contents is an open addressing hash table,
+     * so finding a resource is a probe or two and only the pages of the resources actually
+     * read are ever loaded.
+     *
+     * Uncompressed resources are used in place through find() or open(). Compressed ones are
+     * decompressed by read() into a buffer of the caller, chunks in parallel.
+     */
+    class PackReader
+    {
+    public:
+        static constexpr uint32_t VERSION = 2;
+
+        /* Map and validate `filename`. is_ok() is false when it is missing or malformed. */
+        explicit PackReader(const std::string& filename);
+
+        bool is_ok() const { return is_valid; }
+        int get_resource_count() const { return resource_count; }
+
+        bool contains(uint64_t id) const { return find_entry(id) != nullptr; }
+
+        /* Decoded size of resource `id`, 0 when absent. */
+        size_t get_resource_size(uint64_t id) const;
+        bool is_compressed(uint64_t id) const;
+
+        /*
+         * Bytes of resource `id`, empty when the pack does not have it or it is compressed.
+         * Valid while the pack is mapped.
+         */
+        std::span<const uint8_t> find(uint64_t id) const;
+        std::span<const uint8_t> find(std::string_view name) const { return find(hash_resource_name(name)); }
+
+        /*
+         * Little endian reader over resource `id` that keeps its memory alive: the mapping, or
+         * for a compressed resource a buffer it is decoded into with read(). Reads nothing when
+         * the resource is absent or corrupt.
+         */
+        BinaryReader open(uint64_t id, pf::ThreadPool* thread_pool = nullptr) const;
+        BinaryReader open(std::string_view name, pf::ThreadPool* thread_pool = nullptr) const
+        {
+            return open(hash_resource_name(name), thread_pool);
+        }
+
+        /*
+         * Decode resource `id` into `out_data`, which must have get_resource_size(id) bytes.
+         * Chunks are decompressed straight into place on `thread_pool`, the shared pool when
+         * null. False when the resource is absent or corrupt.
+         */
+        bool read(uint64_t id, std::span<uint8_t> out_data, pf::ThreadPool* thread_pool = nullptr) const;
+
+    private:
+        const PackTocEntry* find_entry(uint64_t id) const;
+
+        std::shared_ptr<const MappedFile> mapping;
+        std::span<const PackTocEntry> buckets;
+        std::vector<PackTocEntry> bucket_storage;
+        int resource_count = 0;
+        bool is_valid = false;
+    };
+}
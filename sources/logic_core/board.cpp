@@ -0,0 +1,298 @@
+#include "board.h"
+
+#include <bit>
+#include <cassert>
+#include <utility>
+
+#include "logic_core/hand_evaluator.h"
+#include "logic_core/rules.h"
+
+namespace logic_core
+{
+    using zobrist::Location;
+
+    Board::Board(int width, int height, CardSet deck) :
+        width(static_cast<uint8_t>(width)),
+        height(static_cast<uint8_t>(height)),
+        line_table(&grid::LineTable::get(width, height, LINE_LENGTH)),
+        card_deck(deck)
+    {
+        assert(width > 0 && width <= zobrist::MAX_WIDTH);
+        assert(height > 0 && height <= zobrist::MAX_HEIGHT);
+        hash = compute_hash();
+    }
+
+    uint64_t Board::compute_hash() const
+    {
+        uint64_t result = 0;
+
+        for (int cell : grid::CellRange(occupancy))
+            result ^= zobrist::cell_key(grid::get_cell_x(cell), grid::get_cell_y(cell), cells[cell]);
+
+        for (Card card : hand_cards)
+            result ^= zobrist::location_key(Location::Hand, card.to_index());
+        for (Card card : rival_cards)
+            result ^= zobrist::location_key(Location::Rival, card.to_index());
+        for (Card card : card_deck)
+            result ^= zobrist::location_key(Location::Deck, card.to_index());
+
+        if (side_to_move == Side::Rival)
+            result ^= zobrist::side_key();
+        result ^= zobrist::hidden_count_key(rival_hidden_count);
+
+        return result;
+    }
+
+    Board Board::get_view(Side side) const
+    {
+        assert(rival_hidden_count == 0);
+
+        Board view = *this;
+        if (side == Side::Rival)
+        {
+            std::swap(view.hand_cards, view.rival_cards);
+            std::swap(view.scores[0], view.scores[1]);
+            view.side_to_move = get_opponent(side_to_move);
+        }
+        view.history_size = 0;
+        view.hash = view.compute_hash();
+        view.hide_rival_cards();
+        return view;
+    }
+
+    CardSet Board::get_cards_in(uint64_t mask) const
+    {
+        uint64_t bits = 0;
+        for (int cell : grid::CellRange(mask & occupancy))
+            bits |= uint64_t(1) << cells[cell];
+        return CardSet(bits);
+    }
+
+    void Board::deal_to_hand(const Card& card)
+    {
+        assert(card_deck.contains(card));
+        card_deck.erase(card);
+        hand_cards.insert(card);
+        hash ^= zobrist::location_key(Location::Deck, card.to_index()) ^ zobrist::location_key(Location::Hand, card.to_index());
+    }
+
+    void Board::deal_to_rival(const Card& card)
+    {
+        assert(card_deck.contains(card));
+        card_deck.erase(card);
+        rival_cards.insert(card);
+        hash ^= zobrist::location_key(Location::Deck, card.to_index()) ^ zobrist::location_key(Location::Rival, card.to_index());
+    }
+
+    void Board::return_to_deck(const Card& card)
+    {
+        Location from = hand_cards.contains(card) ? Location::Hand : Location::Rival;
+        assert(from == Location::Hand || rival_cards.contains(card));
+
+        hand_cards.erase(card);
+        rival_cards.erase(card);
+        card_deck.insert(card);
+        hash ^= zobrist::location_key(from, card.to_index()) ^ zobrist::location_key(Location::Deck, card.to_index());
+    }
+
+    void Board::deal_hidden_to_rival()
+    {
+        assert(card_deck.size() > rival_hidden_count);
+        set_rival_hidden_count(rival_hidden_count + 1);
+    }
+
+    void Board::reveal_to_rival(const Card& card)
+    {
+        assert(rival_hidden_count > 0);
+        deal_to_rival(card);
+        set_rival_hidden_count(rival_hidden_count - 1);
+    }
+
+    void Board::hide_rival_cards()
+    {
+        int count = rival_cards.size();
+        for (Card card : rival_cards)
+            return_to_deck(card);
+        set_rival_hidden_count(rival_hidden_count + count);
+    }
+
+    void Board::put(int x, int y, const Card& card)
+    {
+        put_card(x, y, card);
+    }
+
+    void Board::take_to_hand(int x, int y)
+    {
+        take_to(x, y, Location::Hand);
+    }
+
+    void Board::take_to_rival(int x, int y)
+    {
+        take_to(x, y, Location::Rival);
+    }
+
+    void Board::take_to_deck(int x, int y)
+    {
+        take_to(x, y, Location::Deck);
+    }
+
+    bool Board::is_game_over() const
+    {
+        return get_empty_cells() == 0 || get_held_count(side_to_move) == 0;
+    }
+
+    int Board::get_move_capacity() const
+    {
+        return std::popcount(get_empty_cells()) * get_playable_cards(side_to_move).size();
+    }
+
+    int Board::generate_moves(std::span<Move> out_moves) const
+    {
+        assert(static_cast<int>(out_moves.size()) >= get_move_capacity());
+
+        CardSet cards = get_playable_cards(side_to_move);
+        int count = 0;
+        for (int cell : grid::CellRange(get_empty_cells()))
+        {
+            for (Card card : cards)
+                out_moves[count++] = Move::place(grid::get_cell_x(cell), grid::get_cell_y(cell), card);
+        }
+        return count;
+    }
+
+    int Board::get_placement_score(int x, int y, const Card& card) const
+    {
+        assert(is_block_empty(x, y));
+        return score_lines_through(x, y, card);
+    }
+
+    void Board::make_move(const Move& move)
+    {
+        assert(history_size < static_cast<int>(history.size()));
+
+        Card card = move.get_card();
+        assert(get_playable_cards(side_to_move).contains(card));
+
+        int score = score_lines_through(move.x, move.y, card);
+        Location from = put_card(move.x, move.y, card);
+        scores[static_cast<int>(side_to_move)] += score;
+
+        /* Only a hidden rival card can come from the deck. */
+        if (from == Location::Deck)
+            set_rival_hidden_count(rival_hidden_count - 1);
+
+        if (move.has_draw())
+        {
+            if (side_to_move == Side::Player)
+                deal_to_hand(move.get_draw());
+            else
+                deal_to_rival(move.get_draw());
+        }
+        else if (move.has_hidden_draw())
+        {
+            assert(side_to_move == Side::Rival);
+            deal_hidden_to_rival();
+        }
+
+        history[history_size++] = UndoRecord{ move, from, static_cast<int16_t>(score) };
+        side_to_move = get_opponent(side_to_move);
+        hash ^= zobrist::side_key();
+    }
+
+    void Board::unmake_move()
+    {
+        assert(history_size > 0);
+
+        const UndoRecord& record = history[--history_size];
+        side_to_move = get_opponent(side_to_move);
+        hash ^= zobrist::side_key();
+
+        if (record.move.has_draw())
+            return_to_deck(record.move.get_draw());
+        else if (record.move.has_hidden_draw())
+            set_rival_hidden_count(rival_hidden_count - 1);
+
+        scores[static_cast<int>(side_to_move)] -= record.score;
+        take_to(record.move.x, record.move.y, record.from);
+        if (record.from == Location::Deck)
+            set_rival_hidden_count(rival_hidden_count + 1);
+    }
+
+    Location Board::put_card(int x, int y, const Card& card)
+    {
+        Location from;
+        if (hand_cards.contains(card))
+        {
+            from = Location::Hand;
+            hand_cards.erase(card);
+        }
+        else if (rival_cards.contains(card))
+        {
+            from = Location::Rival;
+            rival_cards.erase(card);
+        }
+        else
+        {
+            assert(card_deck.contains(card));
+            from = Location::Deck;
+            card_deck.erase(card);
+        }
+
+        assert(is_block_empty(x, y));
+        int cell = grid::get_cell(x, y);
+        occupancy |= grid::get_cell_bit(cell);
+        cells[cell] = static_cast<uint8_t>(card.to_index());
+        board_cards.insert(card);
+        hash ^= zobrist::location_key(from, card.to_index()) ^ zobrist::cell_key(x, y, card.to_index());
+        return from;
+    }
+
+    Card Board::take(int x, int y)
+    {
+        assert(!is_block_empty(x, y));
+
+        int cell = grid::get_cell(x, y);
+        Card card = Card::from_index(cells[cell]);
+        occupancy &= ~grid::get_cell_bit(cell);
+        board_cards.erase(card);
+        hash ^= zobrist::cell_key(x, y, card.to_index());
+        return card;
+    }
+
+    void Board::take_to(int x, int y, Location location)
+    {
+        Card card = take(x, y);
+        if (location == Location::Hand)
+            hand_cards.insert(card);
+        else if (location == Location::Rival)
+            rival_cards.insert(card);
+        else
+            card_deck.insert(card);
+        hash ^= zobrist::location_key(location, card.to_index());
+    }
+
+    void Board::set_rival_hidden_count(int count)
+    {
+        hash ^= zobrist::hidden_count_key(rival_hidden_count) ^ zobrist::hidden_count_key(count);
+        rival_hidden_count = static_cast<uint8_t>(count);
+    }
+
+    int Board::score_lines_through(int x, int y, const Card& card) const
+    {
+        int cell = grid::get_cell(x, y);
+        uint64_t filled = occupancy | grid::get_cell_bit(cell);
+
+        int score = 0;
+        for (int i = 0; i < line_table->get_cell_line_count(cell); ++i)
+        {
+            uint64_t line = line_table->get_cell_line(cell, i);
+            if ((filled & line) != line)
+                continue;
+
+            CardSet hand = get_cards_in(line & ~grid::get_cell_bit(cell));
+            hand.insert(card);
+            score += get_line_score(evaluate_hand(hand).get_category());
+        }
+        return score;
+    }
+}
@@ -1,28 +1,207 @@
-#include <vector>
-#include <optional>
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
 
 #include "logic_core/card.h"
+#include "logic_core/card_set.h"
+#include "logic_core/grid.h"
+#include "logic_core/move.h"
+#include "logic_core/zobrist.h"
 
 namespace logic_core
 {
-    class Block
+    /*
+     * Game state seen by the local player: the block grid, the player's hand, the rival's
+     * revealed cards and the deck. Cards the player has not seen, including the rival's
+     * hidden ones, count as being in the deck; get_rival_hidden_count() tells how many of
+     * the deck cards the rival actually holds. A board with no hidden cards is a full
+     * information state, e.g. on a server or inside a search.
+     *
+     * The board keeps an incremental Zobrist hash of the grid, of which cards are in the
+     * hand, the rival's cards and the deck, and of the side to move. Scores are not hashed.
+     * Every mutation goes through the methods below so the hash stays current.
+     *
+     * Turns are played with make_move() and taken back with unmake_move(). The undo records
+     * live in a fixed array inside the board, so exploring a line of play never allocates.
+     *
+     * The grid is stored flat: an occupancy bitboard (see grid.h for the cell layout) and a
+     * parallel array of card indices. Line queries are mask tests against a shared
+     * LineTable, and the whole board is a few hundred bytes of plain data.
+     */
+    class Board
     {
     public:
-        void put(const Card& card);
+        /* Empty grid with every card of `deck` in the deck. Dimensions are limited to 8x8. */
+        Board(int width = 5, int height = 5, CardSet deck = CardSet::full_deck());
 
-    private:
-        bool is_empty = true;
-        Card card;
-    };
+        int get_width() const { return width; }
+        int get_height() const { return height; }
 
-    class Board
-    {
-    public:
+        bool is_block_empty(int x, int y) const { return !(occupancy & grid::get_cell_bit(grid::get_cell(x, y))); }
+
+        /* Card on block (x, y). The block must not be empty. */
+        Card get_card(int x, int y) const { return Card::from_index(cells[grid::get_cell(x, y)]); }
+
+        /* Occupied cells, empty cells and all cells of the board as grid masks. */
+        uint64_t get_occupancy() const { return occupancy; }
+        uint64_t get_empty_cells() const { return grid::get_board_mask(width, height) & ~occupancy; }
+
+        /* Cards on the occupied cells of `mask`. */
+        CardSet get_cards_in(uint64_t mask) const;
+
+        /* All lines of this board; a line is complete when (get_occupancy() & line) == line. */
+        const grid::LineTable& get_line_table() const { return *line_table; }
+
+        /* Call fn(line_mask) for every complete line. */
+        template<typename Fn>
+        void for_each_complete_line(Fn&& fn) const
+        {
+            for (int i = 0; i < line_table->get_line_count(); ++i)
+            {
+                uint64_t line = line_table->get_line(i);
+                if ((occupancy & line) == line)
+                    fn(line);
+            }
+        }
+
+        /* Call fn(line_mask) for every complete line covering block (x, y). */
+        template<typename Fn>
+        void for_each_complete_line_through(int x, int y, Fn&& fn) const
+        {
+            int cell = grid::get_cell(x, y);
+            for (int i = 0; i < line_table->get_cell_line_count(cell); ++i)
+            {
+                uint64_t line = line_table->get_cell_line(cell, i);
+                if ((occupancy & line) == line)
+                    fn(line);
+            }
+        }
+
+        CardSet get_hand_cards() const { return hand_cards; }
+        CardSet get_rival_cards() const { return rival_cards; }
+        CardSet get_card_deck() const { return card_deck; }
+
+        /* Cards lying on the grid. */
+        CardSet get_board_cards() const { return board_cards; }
+
+        uint64_t get_hash() const { return hash; }
+
+        Side get_side_to_move() const { return side_to_move; }
+        int get_score(Side side) const { return scores[static_cast<int>(side)]; }
+
+        /* Number of cards the rival holds that are not revealed. They are part of the deck. */
+        int get_rival_hidden_count() const { return rival_hidden_count; }
+
+        /* Cards the side is known to hold: the hand, or the rival's revealed cards. */
+        CardSet get_side_cards(Side side) const { return side == Side::Player ? hand_cards : rival_cards; }
+
+        /* Cards the side may play. A rival with hidden cards may play any card of the deck. */
+        CardSet get_playable_cards(Side side) const
+        {
+            if (side == Side::Rival && rival_hidden_count > 0)
+                return rival_cards | card_deck;
+            return get_side_cards(side);
+        }
+
+        /* Number of cards the side holds, hidden or not. */
+        int get_held_count(Side side) const
+        {
+            return get_side_cards(side).size() + (side == Side::Rival ? rival_hidden_count : 0);
+        }
+
+        /* Number of moves made and not taken back. */
+        int get_ply() const { return history_size; }
+        const Move& get_move(int ply) const { return history[ply].move; }
+
+        /* True when the grid is full or the side to move has no card to play. */
+        bool is_game_over() const;
+
+        /* Upper bound of the number of moves generate_moves() writes. */
+        int get_move_capacity() const;
+
+        /* Write every placement of the side to move, without draws, and return their count. */
+        int generate_moves(std::span<Move> out_moves) const;
+
+        /* Points the side to move would score by putting `card` on block (x, y). */
+        int get_placement_score(int x, int y, const Card& card) const;
+
+        /* Play a turn for the side to move and record it for unmake_move(). */
+        void make_move(const Move& move);
+
+        /* Take back the last move. */
+        void unmake_move();
+
+        /*
+         * The board as `side` sees it: `side` becomes Side::Player and the cards of its
+         * opponent become hidden rival cards. The board must have no hidden cards itself.
+         * The view starts without move history.
+         */
+        Board get_view(Side side) const;
+
+        /* Hash recomputed from scratch. Always equal to get_hash(); meant for checks. */
+        uint64_t compute_hash() const;
+
+        /* Move a card from the deck to the player's hand. */
+        void deal_to_hand(const Card& card);
+
+        /* Move a card from the deck to the rival's revealed cards. */
+        void deal_to_rival(const Card& card);
+
+        /* Move a card from the player's hand or the rival's revealed cards back to the deck. */
+        void return_to_deck(const Card& card);
+
+        /* The rival draws a card the player does not see. */
+        void deal_hidden_to_rival();
+
+        /* Reveal one of the rival's hidden cards, moving `card` from the deck to the rival's cards. */
+        void reveal_to_rival(const Card& card);
+
+        /* Hide every revealed rival card, e.g. to build the player's view of a full information board. */
+        void hide_rival_cards();
+
+        /*
+         * Put a card on the empty block (x, y). The card is taken from whichever of the hand,
+         * the rival's cards or the deck holds it; a hidden rival card comes from the deck.
+         */
+        void put(int x, int y, const Card& card);
+
+        /* Take the card off block (x, y) and give it to the hand, the rival or the deck. */
+        void take_to_hand(int x, int y);
+        void take_to_rival(int x, int y);
+        void take_to_deck(int x, int y);
 
     private:
-        std::vector<std::vector<Block>> blocks;
-        std::vector<Card> hand_cards;
-        std::vector<Card> rival_cards;
-        std::vector<Card> card_deck;
+        struct UndoRecord
+        {
+            Move move;
+            zobrist::Location from;
+            int16_t score;
+        };
+
+        zobrist::Location put_card(int x, int y, const Card& card);
+        Card take(int x, int y);
+        void take_to(int x, int y, zobrist::Location location);
+        void set_rival_hidden_count(int count);
+        int score_lines_through(int x, int y, const Card& card) const;
+
+        uint8_t width;
+        uint8_t height;
+        uint64_t occupancy = 0;
+        std::array<uint8_t, grid::MAX_CELLS> cells{};
+        const grid::LineTable* line_table;
+
+        CardSet hand_cards;
+        CardSet rival_cards;
+        CardSet card_deck;
+        CardSet board_cards;
+        uint8_t rival_hidden_count = 0;
+        uint64_t hash = 0;
+
+        Side side_to_move = Side::Player;
+        int scores[2] = {};
+        std::array<UndoRecord, zobrist::MAX_CELLS> history;
+        int history_size = 0;
     };
-}
\ No newline at end of file
+}
@@ -1,8 +1,10 @@
-#include <vector>
+#pragma once
+
+#include <cstdint>
 
 namespace logic_core
 {
-    enum class CardRank
+    enum class CardRank : int8_t
     {
         A = 1,
         _2 = 2,
@@ -21,17 +23,88 @@ namespace logic_core
         RedJoker = -2,
     };
 
-    enum class CardSuit
+    enum class CardSuit : uint8_t
     {
+        None = 0,
         Spade = 1,
         Club = 2,
         Diamond = 3,
         Heart = 4,
     };
 
+    /* Position of a rank in poker order: 2 is 0, K is 11 and A is 12. Not valid for jokers. */
+    constexpr int rank_order(CardRank rank)
+    {
+        return rank == CardRank::A ? 12 : static_cast<int>(rank) - 2;
+    }
+
+    constexpr CardRank rank_from_order(int order)
+    {
+        return order == 12 ? CardRank::A : static_cast<CardRank>(order + 2);
+    }
+
+    /* Position of a suit in [0, 4). Not valid for jokers. */
+    constexpr int suit_order(CardSuit suit)
+    {
+        return static_cast<int>(suit) - 1;
+    }
+
+    constexpr CardSuit suit_from_order(int order)
+    {
+        return static_cast<CardSuit>(order + 1);
+    }
+
+    /* A single card. Jokers carry CardSuit::None. Two bytes, trivially copyable. */
     class Card
     {
+    public:
+        /* Number of distinct cards, i.e. 52 standard cards and two jokers. */
+        static constexpr int INDEX_COUNT = 54;
+        static constexpr int BLACK_JOKER_INDEX = 52;
+        static constexpr int RED_JOKER_INDEX = 53;
+
+        constexpr Card() : rank(CardRank::A), suit(CardSuit::Spade) {}
+        constexpr Card(CardRank rank, CardSuit suit) :
+            rank(rank),
+            suit(is_joker_rank(rank) ? CardSuit::None : suit)
+        {}
+
+        constexpr CardRank get_rank() const { return rank; }
+        constexpr CardSuit get_suit() const { return suit; }
+        constexpr bool is_joker() const { return is_joker_rank(rank); }
+
+        /*
+         * Dense index of the card in [0, INDEX_COUNT). Standard cards are laid out suit by suit
+         * in poker rank order (index = suit_order * 13 + rank_order), followed by both jokers.
+         * This is also the bit position used by CardSet.
+         */
+        constexpr int to_index() const
+        {
+            if (rank == CardRank::BlackJoker)
+                return BLACK_JOKER_INDEX;
+            if (rank == CardRank::RedJoker)
+                return RED_JOKER_INDEX;
+            return suit_order(suit) * 13 + rank_order(rank);
+        }
+
+        static constexpr Card from_index(int index)
+        {
+            if (index == BLACK_JOKER_INDEX)
+                return Card(CardRank::BlackJoker, CardSuit::None);
+            if (index == RED_JOKER_INDEX)
+                return Card(CardRank::RedJoker, CardSuit::None);
+            return Card(rank_from_order(index % 13), suit_from_order(index / 13));
+        }
+
+        constexpr bool operator==(const Card& other) const = default;
+
+    private:
+        static constexpr bool is_joker_rank(CardRank rank)
+        {
+            return rank == CardRank::BlackJoker || rank == CardRank::RedJoker;
+        }
+
         CardRank rank;
         CardSuit suit;
     };
-}
\ No newline at end of file
+}
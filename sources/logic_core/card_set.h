@@ -0,0 +1,147 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+
+#include "logic_core/card.h"
+
+namespace logic_core
+{
+    /*
+     * A set of cards packed into a single 64-bit mask. Bit i holds the card with
+     * Card::to_index() == i, so each suit occupies a 13-bit lane in poker rank order
+     * (bit 0 of a lane is the 2, bit 12 is the ace) and the jokers sit at bits 52 and 53.
+     * All operations are constexpr and allocation free.
+     */
+    class CardSet
+    {
+    public:
+        static constexpr int RANK_COUNT = 13;
+        static constexpr int SUIT_COUNT = 4;
+
+        static constexpr uint64_t RANK_LANE_MASK = (uint64_t(1) << RANK_COUNT) - 1;
+        static constexpr uint64_t STANDARD_MASK = (uint64_t(1) << 52) - 1;
+        static constexpr uint64_t JOKER_MASK = uint64_t(3) << Card::BLACK_JOKER_INDEX;
+        static constexpr uint64_t ALL_MASK = STANDARD_MASK | JOKER_MASK;
+
+        class Iterator
+        {
+        public:
+            constexpr explicit Iterator(uint64_t bits) : bits(bits) {}
+
+            constexpr Card operator*() const { return Card::from_index(std::countr_zero(bits)); }
+            constexpr Iterator& operator++() { bits &= bits - 1; return *this; }
+            constexpr bool operator==(const Iterator& other) const = default;
+
+        private:
+            uint64_t bits;
+        };
+
+        constexpr CardSet() = default;
+        constexpr explicit CardSet(uint64_t bits) : bits(bits & ALL_MASK) {}
+        constexpr CardSet(std::initializer_list<Card> cards)
+        {
+            for (const Card& card : cards)
+                insert(card);
+        }
+
+        /* All 54 cards. */
+        static constexpr CardSet full_deck() { return CardSet(ALL_MASK); }
+
+        /* The 52 cards without jokers. */
+        static constexpr CardSet standard_deck() { return CardSet(STANDARD_MASK); }
+
+        static constexpr CardSet jokers() { return CardSet(JOKER_MASK); }
+
+        /* All 13 cards of a suit. */
+        static constexpr CardSet of_suit(CardSuit suit)
+        {
+            return CardSet(RANK_LANE_MASK << (suit_order(suit) * RANK_COUNT));
+        }
+
+        /* All 4 cards of a rank, or the single joker for joker ranks. */
+        static constexpr CardSet of_rank(CardRank rank)
+        {
+            if (rank == CardRank::BlackJoker || rank == CardRank::RedJoker)
+                return CardSet(bit_of(Card(rank, CardSuit::None)));
+
+            uint64_t lane_bit = uint64_t(1) << rank_order(rank);
+            return CardSet(lane_bit | lane_bit << RANK_COUNT | lane_bit << 2 * RANK_COUNT | lane_bit << 3 * RANK_COUNT);
+        }
+
+        static constexpr uint64_t bit_of(const Card& card) { return uint64_t(1) << card.to_index(); }
+
+        constexpr uint64_t get_bits() const { return bits; }
+        constexpr int size() const { return std::popcount(bits); }
+        constexpr bool empty() const { return bits == 0; }
+
+        constexpr bool contains(const Card& card) const { return (bits & bit_of(card)) != 0; }
+        constexpr bool contains_all(CardSet other) const { return (bits & other.bits) == other.bits; }
+        constexpr bool intersects(CardSet other) const { return (bits & other.bits) != 0; }
+
+        constexpr void insert(const Card& card) { bits |= bit_of(card); }
+        constexpr void erase(const Card& card) { bits &= ~bit_of(card); }
+        constexpr void clear() { bits = 0; }
+
+        /* 13-bit rank mask of one suit, bit 0 being the 2 and bit 12 the ace. */
+        constexpr uint32_t get_suit_ranks(CardSuit suit) const
+        {
+            return static_cast<uint32_t>(bits >> (suit_order(suit) * RANK_COUNT) & RANK_LANE_MASK);
+        }
+
+        /* Ranks present in any suit. */
+        constexpr uint32_t get_rank_mask() const
+        {
+            return static_cast<uint32_t>((bits | bits >> RANK_COUNT | bits >> 2 * RANK_COUNT | bits >> 3 * RANK_COUNT) & RANK_LANE_MASK);
+        }
+
+        constexpr int count_suit(CardSuit suit) const { return std::popcount(get_suit_ranks(suit)); }
+        constexpr int count_rank(CardRank rank) const { return (*this & of_rank(rank)).size(); }
+        constexpr int count_jokers() const { return std::popcount(bits & JOKER_MASK); }
+
+        /* Card with the lowest index. The set must not be empty. */
+        constexpr Card front() const { return Card::from_index(std::countr_zero(bits)); }
+
+        /* Remove and return the card with the lowest index. The set must not be empty. */
+        constexpr Card pop_front()
+        {
+            Card card = front();
+            bits &= bits - 1;
+            return card;
+        }
+
+        /* The n-th card in index order, n in [0, size()). */
+        constexpr Card nth(int n) const
+        {
+            uint64_t rest = bits;
+            for (; n > 0; --n)
+                rest &= rest - 1;
+            return Card::from_index(std::countr_zero(rest));
+        }
+
+        constexpr Iterator begin() const { return Iterator(bits); }
+        constexpr Iterator end() const { return Iterator(0); }
+
+        constexpr CardSet operator|(CardSet other) const { return CardSet(bits | other.bits); }
+        constexpr CardSet operator&(CardSet other) const { return CardSet(bits & other.bits); }
+        constexpr CardSet operator^(CardSet other) const { return CardSet(bits ^ other.bits); }
+        constexpr CardSet operator-(CardSet other) const { return CardSet(bits & ~other.bits); }
+        constexpr CardSet operator~() const { return CardSet(~bits); }
+
+        constexpr CardSet& operator|=(CardSet other) { bits |= other.bits; return *this; }
+        constexpr CardSet& operator&=(CardSet other) { bits &= other.bits; return *this; }
+        constexpr CardSet& operator^=(CardSet other) { bits ^= other.bits; return *this; }
+        constexpr CardSet& operator-=(CardSet other) { bits &= ~other.bits; return *this; }
+
+        constexpr bool operator==(const CardSet& other) const = default;
+
+    private:
+        uint64_t bits = 0;
+    };
+
+    static_assert(sizeof(CardSet) == sizeof(uint64_t));
+    static_assert(CardSet::full_deck().size() == Card::INDEX_COUNT);
+    static_assert(CardSet::of_suit(CardSuit::Heart).size() == 13);
+    static_assert(CardSet::of_rank(CardRank::A).get_rank_mask() == 1u << 12);
+}
@@ -0,0 +1,78 @@
+#include "dealer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "common/thread_pool.h"
+
+namespace logic_core
+{
+    Dealer::Dealer(CardSet cards, uint64_t seed, uint64_t game_index) :
+        philox(seed),
+        game_index(game_index)
+    {
+        for (Card card : cards)
+            this->cards[card_count++] = static_cast<uint8_t>(card.to_index());
+    }
+
+    CardSet Dealer::get_remaining_cards() const
+    {
+        CardSet remaining;
+        for (int i = dealt_count; i < card_count; ++i)
+            remaining.insert(Card::from_index(cards[i]));
+        return remaining;
+    }
+
+    Card Dealer::deal()
+    {
+        assert(dealt_count < card_count);
+
+        if (dealt_count % 4 == 0)
+            block = philox.generate(dealt_count / 4, game_index);
+
+        /* Multiply-shift into [dealt_count, card_count); the bias is below 2^-26 for a 54 card deck. */
+        uint32_t range = static_cast<uint32_t>(card_count - dealt_count);
+        int pick = dealt_count + static_cast<int>(uint64_t(block[dealt_count % 4]) * range >> 32);
+        std::swap(cards[dealt_count], cards[pick]);
+        return Card::from_index(cards[dealt_count++]);
+    }
+
+    void Dealer::deal(std::span<Card> out_cards)
+    {
+        for (Card& card : out_cards)
+            card = deal();
+    }
+
+    std::span<const uint8_t> Dealer::deal_all()
+    {
+        int first = dealt_count;
+        while (dealt_count < card_count)
+            deal();
+        return std::span<const uint8_t>(cards.data() + first, cards.data() + card_count);
+    }
+
+    void deal_decks(CardSet cards, uint64_t seed, uint64_t first_game, int deal_count,
+        std::span<uint8_t> out_cards, pf::ThreadPool* thread_pool)
+    {
+        assert(deal_count > 0 && deal_count <= cards.size());
+        assert(out_cards.size() % deal_count == 0);
+
+        /* Games per task; dealing one is a few dozen nanoseconds. */
+        constexpr size_t games_per_task = 4096;
+
+        size_t game_count = out_cards.size() / deal_count;
+        size_t task_count = (game_count + games_per_task - 1) / games_per_task;
+        pf::ThreadPool& pool = thread_pool ? *thread_pool : pf::ThreadPool::get_shared();
+        pool.parallel_for(task_count, [&](size_t task) {
+            size_t end = std::min(game_count, (task + 1) * games_per_task);
+            for (size_t game = task * games_per_task; game < end; ++game)
+            {
+                Dealer dealer(cards, seed, first_game + game);
+                uint8_t* out = out_cards.data() + game * deal_count;
+                for (int i = 0; i < deal_count; ++i)
+                    out[i] = static_cast<uint8_t>(dealer.deal().to_index());
+            }
+        });
+    }
+}
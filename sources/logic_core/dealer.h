@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "common/random.h"
+#include "logic_core/card.h"
+#include "logic_core/card_set.h"
+
+namespace pf
+{
+    class ThreadPool;
+}
+
+namespace logic_core
+{
+    /*
+     * Reproducible dealing. The deck of a game is a Fisher-Yates shuffle of a card set, in
+     * ascending card index order, driven by Philox keyed with the seed. Shuffle step i of game
+     * g reads word i % 4 of counter (i / 4, g), so a game's deck is rebuilt from the seed and
+     * its index alone, whatever was dealt before it and on whichever thread.
+     *
+     * The shuffle is lazy: every deal() runs only the step that picks the next card, so a
+     * game that uses ten cards of the deck pays for ten steps instead of a full shuffle.
+     */
+    class Dealer
+    {
+    public:
+        Dealer(CardSet cards, uint64_t seed, uint64_t game_index);
+
+        int get_dealt_count() const { return dealt_count; }
+        int get_remaining_count() const { return card_count - dealt_count; }
+
+        /* Cards not dealt yet. */
+        CardSet get_remaining_cards() const;
+
+        /* Next card of the deck. At least one card must remain. */
+        Card deal();
+
+        /* Deal the next out_cards.size() cards. */
+        void deal(std::span<Card> out_cards);
+
+        /* Deal every remaining card, as card indices in deck order. */
+        std::span<const uint8_t> deal_all();
+
+    private:
+        pf::Philox4x32 philox;
+        uint64_t game_index;
+        pf::Philox4x32::Block block{};
+
+        std::array<uint8_t, Card::INDEX_COUNT> cards;
+        int card_count = 0;
+        int dealt_count = 0;
+    };
+
+    /*
+     * Deal the first `deal_count` cards of the decks of games first_game, first_game + 1, ...
+     * into one flat buffer of card indices, out_cards.size() / deal_count games back to back.
+     * Deck k is exactly what Dealer(cards, seed, first_game + k) deals.
+     */
+    void deal_decks(CardSet cards, uint64_t seed, uint64_t first_game, int deal_count,
+        std::span<uint8_t> out_cards, pf::ThreadPool* thread_pool = nullptr);
+}
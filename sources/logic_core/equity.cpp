@@ -0,0 +1,395 @@
+#include "equity.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "common/random.h"
+#include "common/thread_pool.h"
+#include "logic_core/hand_evaluator.h"
+
+namespace logic_core
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        void add_outcome(EquityResult& result, HandValue hero, HandValue rival, uint64_t weight = 1)
+        {
+            if (hero > rival)
+                result.wins += weight;
+            else if (hero < rival)
+                result.losses += weight;
+            else
+                result.ties += weight;
+        }
+
+        void merge(EquityResult& result, const EquityResult& other)
+        {
+            result.wins += other.wins;
+            result.ties += other.ties;
+            result.losses += other.losses;
+        }
+
+        constexpr int MAX_POOL_SIZE = Card::INDEX_COUNT;
+
+        /* BINOMIAL[n][k] = n choose k. The largest entry, C(54, 27), fits comfortably. */
+        constexpr auto BINOMIAL = [] {
+            std::array<std::array<uint64_t, MAX_POOL_SIZE + 1>, MAX_POOL_SIZE + 1> table{};
+            for (int n = 0; n <= MAX_POOL_SIZE; ++n)
+            {
+                table[n][0] = 1;
+                for (int k = 1; k <= n; ++k)
+                    table[n][k] = table[n - 1][k - 1] + table[n - 1][k];
+            }
+            return table;
+        }();
+
+        using SuitPermutation = std::array<uint8_t, CardSet::SUIT_COUNT>;
+
+        CardSet permute_suits(CardSet cards, const SuitPermutation& permutation)
+        {
+            uint64_t bits = cards.get_bits();
+            uint64_t result = bits & CardSet::JOKER_MASK;
+            for (int suit = 0; suit < CardSet::SUIT_COUNT; ++suit)
+            {
+                uint64_t lane = bits >> (suit * CardSet::RANK_COUNT) & CardSet::RANK_LANE_MASK;
+                result |= lane << (permutation[suit] * CardSet::RANK_COUNT);
+            }
+            return CardSet(result);
+        }
+
+        /*
+         * Suit permutations that leave the spot unchanged: two suits may be swapped when the
+         * hero, the rival and the unknown pool hold exactly the same ranks in both of them.
+         * Always contains the identity first.
+         */
+        std::vector<SuitPermutation> find_suit_symmetries(const EquitySpot& spot)
+        {
+            auto same_suit_content = [&spot](int a, int b) {
+                for (CardSet cards : { spot.hero_cards, spot.rival_cards, spot.unknown_cards })
+                {
+                    if (cards.get_suit_ranks(suit_from_order(a)) != cards.get_suit_ranks(suit_from_order(b)))
+                        return false;
+                }
+                return true;
+            };
+
+            std::vector<SuitPermutation> symmetries;
+            SuitPermutation permutation = { 0, 1, 2, 3 };
+            do
+            {
+                bool is_symmetry = true;
+                for (int suit = 0; suit < CardSet::SUIT_COUNT && is_symmetry; ++suit)
+                    is_symmetry = same_suit_content(suit, permutation[suit]);
+
+                if (is_symmetry)
+                    symmetries.push_back(permutation);
+            }
+            while (std::next_permutation(permutation.begin(), permutation.end()));
+            return symmetries;
+        }
+
+        /*
+         * Orbit size of `cards` under the symmetries if `cards` is the smallest member of its
+         * orbit, zero otherwise. Enumerating only orbit minima, weighted, covers every subset once.
+         */
+        uint64_t canonical_weight(CardSet cards, const std::vector<SuitPermutation>& symmetries)
+        {
+            uint64_t images[24];
+            size_t image_count = 0;
+            for (const SuitPermutation& permutation : symmetries)
+            {
+                uint64_t image = permute_suits(cards, permutation).get_bits();
+                if (image < cards.get_bits())
+                    return 0;
+                if (std::find(images, images + image_count, image) == images + image_count)
+                    images[image_count++] = image;
+            }
+            return image_count;
+        }
+
+        /* Next bit mask with the same popcount (Gosper's hack), i.e. the next combination in colex order. */
+        uint64_t next_combination(uint64_t positions)
+        {
+            uint64_t lowest = positions & (~positions + 1);
+            uint64_t ripple = positions + lowest;
+            return (((ripple ^ positions) >> 2) / lowest) | ripple;
+        }
+
+        /* The `rank`-th `size`-subset of [0, n) in colex order. */
+        uint64_t unrank_combination(uint64_t rank, int n, int size)
+        {
+            uint64_t positions = 0;
+            int limit = n;
+            for (int i = size; i > 0; --i)
+            {
+                int c = limit - 1;
+                while (BINOMIAL[c][i] > rank)
+                    --c;
+                positions |= uint64_t(1) << c;
+                rank -= BINOMIAL[c][i];
+                limit = c;
+            }
+            return positions;
+        }
+
+        uint64_t positions_to_cards(uint64_t positions, const uint8_t* pool)
+        {
+            uint64_t cards = 0;
+            for (; positions; positions &= positions - 1)
+                cards |= uint64_t(1) << pool[std::countr_zero(positions)];
+            return cards;
+        }
+
+        /* Draw with a partial Fisher-Yates shuffle of a private copy of the pool. */
+        EquityResult sample(const EquitySpot& spot, const uint8_t* pool, int pool_size, uint64_t seed, uint64_t sample_count)
+        {
+            uint8_t cards[Card::INDEX_COUNT];
+            std::copy(pool, pool + pool_size, cards);
+
+            pf::Xoshiro256 rng(seed);
+            EquityResult result;
+            int draw_count = spot.hero_draws + spot.rival_draws;
+
+            for (uint64_t i = 0; i < sample_count; ++i)
+            {
+                uint64_t hero = spot.hero_cards.get_bits();
+                uint64_t rival = spot.rival_cards.get_bits();
+
+                for (int draw = 0; draw < draw_count; ++draw)
+                {
+                    int pick = draw + static_cast<int>(rng.next_below(static_cast<uint32_t>(pool_size - draw)));
+                    std::swap(cards[draw], cards[pick]);
+
+                    uint64_t bit = uint64_t(1) << cards[draw];
+                    if (draw < spot.hero_draws)
+                        hero |= bit;
+                    else
+                        rival |= bit;
+                }
+
+                add_outcome(result, evaluate_hand(CardSet(hero)), evaluate_hand(CardSet(rival)));
+            }
+            return result;
+        }
+
+        EquityResult sample_equity(const EquitySpot& spot, const EquityOptions& options)
+        {
+            assert(!spot.hero_cards.intersects(spot.rival_cards | spot.unknown_cards));
+            assert(!spot.rival_cards.intersects(spot.unknown_cards));
+
+            uint8_t pool[Card::INDEX_COUNT];
+            int pool_size = 0;
+            for (Card card : spot.unknown_cards)
+                pool[pool_size++] = static_cast<uint8_t>(card.to_index());
+
+            if (spot.hero_draws + spot.rival_draws > pool_size)
+            {
+                assert(false && "not enough unknown cards to complete both hands");
+                return {};
+            }
+
+            EquityResult result;
+            if (spot.hero_draws + spot.rival_draws == 0)
+            {
+                add_outcome(result, evaluate_hand(spot.hero_cards), evaluate_hand(spot.rival_cards));
+                result.is_exact = true;
+                return result;
+            }
+
+            uint64_t seed = options.seed;
+            if (!options.is_deterministic && seed == 0)
+                seed = (uint64_t(std::random_device()()) << 32) | std::random_device()();
+
+            bool has_deadline = !options.is_deterministic && options.time_budget.count() > 0;
+            Clock::time_point deadline = Clock::now() + options.time_budget;
+
+            pf::ThreadPool& thread_pool = options.thread_pool ? *options.thread_pool : pf::ThreadPool::get_shared();
+            uint64_t samples_per_task = std::max<uint32_t>(1, options.samples_per_task);
+            uint64_t tasks_per_round = std::max<uint32_t>(1, options.tasks_per_round);
+            std::vector<EquityResult> task_results(tasks_per_round);
+            uint64_t first_task = 0;
+
+            while (first_task * samples_per_task < options.max_samples)
+            {
+                uint64_t remaining = options.max_samples - first_task * samples_per_task;
+                uint64_t task_count = std::min(tasks_per_round, (remaining + samples_per_task - 1) / samples_per_task);
+
+                thread_pool.parallel_for(task_count, [&](size_t i) {
+                    task_results[i] = {};
+                    if (has_deadline && Clock::now() >= deadline)
+                        return;
+
+                    uint64_t count = std::min(samples_per_task, remaining - i * samples_per_task);
+                    task_results[i] = sample(spot, pool, pool_size, pf::mix_seed(seed, first_task + i), count);
+                });
+
+                /* Merge in task order so the sum never depends on scheduling. */
+                for (uint64_t i = 0; i < task_count; ++i)
+                    merge(result, task_results[i]);
+                first_task += task_count;
+
+                if (options.target_error > 0.0 && result.get_error() < options.target_error)
+                    break;
+                if (has_deadline && Clock::now() >= deadline)
+                    break;
+            }
+            return result;
+        }
+    }
+
+    double EquityResult::get_equity() const
+    {
+        uint64_t count = get_sample_count();
+        if (count == 0)
+            return 0.0;
+        return (wins + 0.5 * ties) / count;
+    }
+
+    double EquityResult::get_error() const
+    {
+        uint64_t count = get_sample_count();
+        if (is_exact)
+            return 0.0;
+        if (count == 0)
+            return 1.0;
+
+        /* Each sample scores 1, 0.5 or 0. */
+        double mean = get_equity();
+        double mean_square = (wins + 0.25 * ties) / count;
+        double variance = std::max(0.0, mean_square - mean * mean);
+        return 1.96 * std::sqrt(variance / count);
+    }
+
+    EquitySpot make_equity_spot(const Board& board, int showdown_size)
+    {
+        EquitySpot spot;
+        spot.hero_cards = board.get_hand_cards();
+        spot.rival_cards = board.get_rival_cards();
+        spot.unknown_cards = board.get_card_deck();
+        spot.hero_draws = std::max(0, showdown_size - spot.hero_cards.size());
+        spot.rival_draws = std::max(0, showdown_size - spot.rival_cards.size());
+        return spot;
+    }
+
+    uint64_t count_completions(const EquitySpot& spot)
+    {
+        int pool_size = spot.unknown_cards.size();
+        if (spot.hero_draws < 0 || spot.rival_draws < 0 || spot.hero_draws + spot.rival_draws > pool_size)
+            return 0;
+
+        uint64_t hero_count = BINOMIAL[pool_size][spot.hero_draws];
+        uint64_t rival_count = BINOMIAL[pool_size - spot.hero_draws][spot.rival_draws];
+        if (hero_count > UINT64_MAX / rival_count)
+            return UINT64_MAX;
+        return hero_count * rival_count;
+    }
+
+    EquityResult enumerate_equity(const EquitySpot& spot, pf::ThreadPool* thread_pool)
+    {
+        assert(!spot.hero_cards.intersects(spot.rival_cards | spot.unknown_cards));
+        assert(!spot.rival_cards.intersects(spot.unknown_cards));
+
+        if (count_completions(spot) == 0)
+        {
+            assert(false && "not enough unknown cards to complete both hands");
+            return {};
+        }
+
+        uint8_t pool[MAX_POOL_SIZE];
+        int pool_size = 0;
+        for (Card card : spot.unknown_cards)
+            pool[pool_size++] = static_cast<uint8_t>(card.to_index());
+
+        /*
+         * The first stage draws for one side and is reduced by suit symmetry; the second stage
+         * draws for the other side from what is left. When the hero draws nothing the rival
+         * becomes the first stage so the reduction still applies.
+         */
+        bool hero_first = spot.hero_draws > 0;
+        CardSet first_cards = hero_first ? spot.hero_cards : spot.rival_cards;
+        CardSet second_cards = hero_first ? spot.rival_cards : spot.hero_cards;
+        int first_draws = hero_first ? spot.hero_draws : spot.rival_draws;
+        int second_draws = hero_first ? spot.rival_draws : 0;
+
+        std::vector<SuitPermutation> symmetries = find_suit_symmetries(spot);
+        HandValue fixed_second_value = evaluate_hand(second_cards);
+
+        pf::ThreadPool& pool_threads = thread_pool ? *thread_pool : pf::ThreadPool::get_shared();
+        uint64_t first_count = BINOMIAL[pool_size][first_draws];
+        uint64_t task_count = std::min<uint64_t>(first_count, pool_threads.get_thread_count() * 16);
+        std::vector<EquityResult> task_results(task_count);
+
+        pool_threads.parallel_for(task_count, [&](size_t task) {
+            uint64_t begin = first_count * task / task_count;
+            uint64_t end = first_count * (task + 1) / task_count;
+            EquityResult& result = task_results[task];
+
+            uint64_t first_positions = unrank_combination(begin, pool_size, first_draws);
+            for (uint64_t rank = begin; rank < end; ++rank)
+            {
+                if (rank != begin)
+                    first_positions = next_combination(first_positions);
+
+                CardSet drawn(positions_to_cards(first_positions, pool));
+                uint64_t weight = symmetries.size() > 1 ? canonical_weight(drawn, symmetries) : 1;
+                if (weight == 0)
+                    continue;
+
+                HandValue first_value = evaluate_hand(first_cards | drawn);
+
+                if (second_draws == 0)
+                {
+                    HandValue hero = hero_first ? first_value : fixed_second_value;
+                    HandValue rival = hero_first ? fixed_second_value : first_value;
+                    add_outcome(result, hero, rival, weight);
+                    continue;
+                }
+
+                uint8_t rest[MAX_POOL_SIZE];
+                int rest_size = 0;
+                for (int i = 0; i < pool_size; ++i)
+                {
+                    if (!(first_positions >> i & 1))
+                        rest[rest_size++] = pool[i];
+                }
+
+                uint64_t second_count = BINOMIAL[rest_size][second_draws];
+                uint64_t second_positions = (uint64_t(1) << second_draws) - 1;
+                for (uint64_t j = 0; j < second_count; ++j)
+                {
+                    if (j != 0)
+                        second_positions = next_combination(second_positions);
+
+                    HandValue second_value = evaluate_hand(second_cards | CardSet(positions_to_cards(second_positions, rest)));
+                    add_outcome(result, first_value, second_value, weight);
+                }
+            }
+        });
+
+        EquityResult result;
+        for (const EquityResult& task_result : task_results)
+            merge(result, task_result);
+        result.is_exact = true;
+        return result;
+    }
+
+    EquityResult estimate_equity(const EquitySpot& spot, const EquityOptions& options)
+    {
+        bool should_enumerate = options.mode == EquityMode::Enumerate ||
+            (options.mode == EquityMode::Auto && count_completions(spot) <= options.enumeration_threshold);
+        if (should_enumerate)
+            return enumerate_equity(spot, options.thread_pool);
+
+        return sample_equity(spot, options);
+    }
+
+    EquityResult estimate_equity(const Board& board, const EquityOptions& options)
+    {
+        return estimate_equity(make_equity_spot(board, options.showdown_size), options);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "logic_core/board.h"
+#include "logic_core/card_set.h"
+
+namespace pf
+{
+    class ThreadPool;
+}
+
+namespace logic_core
+{
+    /*
+     * A showdown seen from the local player: both sides complete their hands with cards
+     * drawn from the unknown pool, then the best five-card hands are compared.
+     */
+    struct EquitySpot
+    {
+        CardSet hero_cards;
+        CardSet rival_cards;
+        CardSet unknown_cards;
+        int hero_draws = 0;
+        int rival_draws = 0;
+    };
+
+    enum class EquityMode
+    {
+        /* Enumerate when the number of completions is at most enumeration_threshold, sample otherwise. */
+        Auto,
+        Sample,
+        Enumerate,
+    };
+
+    struct EquityOptions
+    {
+        /* Cards in each final hand when the spot is built from a Board. */
+        int showdown_size = 7;
+
+        EquityMode mode = EquityMode::Auto;
+        uint64_t enumeration_threshold = 1 << 22;
+
+        /*
+         * Fixed seed and fixed task partitioning. Results are bit-identical between runs and
+         * across thread counts; time_budget is ignored.
+         */
+        bool is_deterministic = false;
+        uint64_t seed = 0;
+
+        /* Sample budget. Sampling stops at whichever budget runs out first. */
+        uint64_t max_samples = 1 << 20;
+        /* Wall clock budget, zero for none. */
+        std::chrono::microseconds time_budget{ 0 };
+        /* Stop once the 95% confidence half-width of the equity is below this, zero to disable. */
+        double target_error = 0.0;
+
+        /* Samples taken by one task. The budget is spent in rounds of tasks_per_round tasks. */
+        uint32_t samples_per_task = 2048;
+        uint32_t tasks_per_round = 64;
+
+        /* Pool to run on, ThreadPool::get_shared() when null. */
+        pf::ThreadPool* thread_pool = nullptr;
+    };
+
+    struct EquityResult
+    {
+        uint64_t wins = 0;
+        uint64_t ties = 0;
+        uint64_t losses = 0;
+
+        /* Counts cover every completion exactly once, i.e. the result is not an estimate. */
+        bool is_exact = false;
+
+        uint64_t get_sample_count() const { return wins + ties + losses; }
+
+        /* Win probability with ties counted as half a win. */
+        double get_equity() const;
+
+        /* Half-width of the 95% confidence interval of get_equity(). */
+        double get_error() const;
+    };
+
+    /* Build the showdown spot of a board from the hand owner's point of view. */
+    EquitySpot make_equity_spot(const Board& board, int showdown_size);
+
+    /* Number of distinct completions of a spot, saturating at UINT64_MAX. */
+    uint64_t count_completions(const EquitySpot& spot);
+
+    /*
+     * Exact win, tie and loss counts over every completion. Suits that are interchangeable
+     * in the spot are enumerated once and weighted by the size of their orbit.
+     */
+    EquityResult enumerate_equity(const EquitySpot& spot, pf::ThreadPool* thread_pool = nullptr);
+
+    /* Win, tie and loss rates, sampled or enumerated according to options.mode. */
+    EquityResult estimate_equity(const EquitySpot& spot, const EquityOptions& options = {});
+    EquityResult estimate_equity(const Board& board, const EquityOptions& options = {});
+}
@@ -0,0 +1,58 @@
+#include "grid.h"
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+namespace logic_core::grid
+{
+    const LineTable& LineTable::get(int width, int height, int length)
+    {
+        assert(width > 0 && width <= MAX_WIDTH && height > 0 && height <= MAX_HEIGHT);
+        assert(length > 0 && length <= MAX_WIDTH);
+
+        constexpr int table_count = MAX_WIDTH * MAX_HEIGHT * MAX_WIDTH;
+        static std::array<std::once_flag, table_count> once_flags;
+        static std::array<std::unique_ptr<LineTable>, table_count> tables;
+
+        int index = ((width - 1) * MAX_HEIGHT + height - 1) * MAX_WIDTH + length - 1;
+        std::call_once(once_flags[index], [&] {
+            tables[index].reset(new LineTable(width, height, length));
+        });
+        return *tables[index];
+    }
+
+    LineTable::LineTable(int width, int height, int length)
+    {
+        static constexpr int directions[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 1, -1 } };
+
+        for (const auto& direction : directions)
+        {
+            int dx = direction[0];
+            int dy = direction[1];
+
+            /* A single cell is a window in every direction; count it once. */
+            if (length == 1 && dy != 0)
+                continue;
+
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    int end_x = x + (length - 1) * dx;
+                    int end_y = y + (length - 1) * dy;
+                    if (end_x >= width || end_y < 0 || end_y >= height)
+                        continue;
+
+                    uint64_t line = 0;
+                    for (int i = 0; i < length; ++i)
+                        line |= get_cell_bit(get_cell(x + i * dx, y + i * dy));
+
+                    for (int cell : CellRange(line))
+                        cell_lines[cell][cell_line_counts[cell]++] = static_cast<uint8_t>(line_count);
+                    lines[line_count++] = line;
+                }
+            }
+        }
+    }
+}
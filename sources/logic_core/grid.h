@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "logic_core/zobrist.h"
+
+namespace logic_core::grid
+{
+    /*
+     * Grid cells are bits of a 64-bit board mask. Rows always have a stride of MAX_WIDTH
+     * whatever the actual width, so cell = y * 8 + x for every board size and shifts by
+     * one row or column are plain shifts.
+     */
+    constexpr int MAX_WIDTH = zobrist::MAX_WIDTH;
+    constexpr int MAX_HEIGHT = zobrist::MAX_HEIGHT;
+    constexpr int MAX_CELLS = zobrist::MAX_CELLS;
+
+    constexpr int get_cell(int x, int y) { return y * MAX_WIDTH + x; }
+    constexpr int get_cell_x(int cell) { return cell % MAX_WIDTH; }
+    constexpr int get_cell_y(int cell) { return cell / MAX_WIDTH; }
+    constexpr uint64_t get_cell_bit(int cell) { return uint64_t(1) << cell; }
+
+    constexpr uint64_t get_row_mask(int y, int width)
+    {
+        return ((uint64_t(1) << width) - 1) << (y * MAX_WIDTH);
+    }
+
+    constexpr uint64_t get_column_mask(int x, int height)
+    {
+        uint64_t column = 0;
+        for (int y = 0; y < height; ++y)
+            column |= get_cell_bit(get_cell(x, y));
+        return column;
+    }
+
+    /* Every cell of a width x height board. */
+    constexpr uint64_t get_board_mask(int width, int height)
+    {
+        uint64_t mask = 0;
+        for (int y = 0; y < height; ++y)
+            mask |= get_row_mask(y, width);
+        return mask;
+    }
+
+    /* The up to eight cells around the cells of `mask`, excluding `mask` itself, clipped to the board. */
+    constexpr uint64_t get_neighbour_mask(uint64_t mask, int width, int height)
+    {
+        constexpr uint64_t not_first_column = ~get_column_mask(0, MAX_HEIGHT);
+        constexpr uint64_t not_last_column = ~get_column_mask(MAX_WIDTH - 1, MAX_HEIGHT);
+
+        uint64_t horizontal = mask | (mask << 1 & not_first_column) | (mask >> 1 & not_last_column);
+        uint64_t around = horizontal | horizontal << MAX_WIDTH | horizontal >> MAX_WIDTH;
+        return around & ~mask & get_board_mask(width, height);
+    }
+
+    /* Iterate the cell indices of a mask: for (int cell : CellRange(mask)). */
+    class CellRange
+    {
+    public:
+        class Iterator
+        {
+        public:
+            constexpr explicit Iterator(uint64_t bits) : bits(bits) {}
+
+            constexpr int operator*() const { return std::countr_zero(bits); }
+            constexpr Iterator& operator++() { bits &= bits - 1; return *this; }
+            constexpr bool operator==(const Iterator& other) const = default;
+
+        private:
+            uint64_t bits;
+        };
+
+        constexpr explicit CellRange(uint64_t bits) : bits(bits) {}
+
+        constexpr Iterator begin() const { return Iterator(bits); }
+        constexpr Iterator end() const { return Iterator(0); }
+
+    private:
+        uint64_t bits;
+    };
+
+    /*
+     * Every line of a board size as a cell mask: windows of `length` consecutive cells
+     * in rows, columns and both diagonals, plus for every cell the lines covering it.
+     * Tables are built once per size and shared by all boards of that size.
+     */
+    class LineTable
+    {
+    public:
+        static constexpr int MAX_LINES = 4 * MAX_WIDTH * MAX_HEIGHT;
+        static constexpr int MAX_LINES_PER_CELL = 4 * 8;
+
+        /* Table for width x height boards and lines of `length` cells, length in [1, 8]. */
+        static const LineTable& get(int width, int height, int length);
+
+        int get_line_count() const { return line_count; }
+        uint64_t get_line(int index) const { return lines[index]; }
+
+        int get_cell_line_count(int cell) const { return cell_line_counts[cell]; }
+        uint64_t get_cell_line(int cell, int index) const { return lines[cell_lines[cell][index]]; }
+
+    private:
+        LineTable(int width, int height, int length);
+
+        std::array<uint64_t, MAX_LINES> lines{};
+        int line_count = 0;
+        std::array<std::array<uint8_t, MAX_LINES_PER_CELL>, MAX_CELLS> cell_lines{};
+        std::array<uint8_t, MAX_CELLS> cell_line_counts{};
+    };
+}
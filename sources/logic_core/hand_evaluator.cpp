@@ -0,0 +1,240 @@
+#include "hand_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+
+namespace logic_core
+{
+    namespace
+    {
+        constexpr int RANK_MASK_COUNT = 1 << CardSet::RANK_COUNT;
+
+        /* Highest rank order of a straight contained in a 13-bit rank mask, or -1. The wheel (A-5) is 3. */
+        constexpr std::array<int8_t, RANK_MASK_COUNT> STRAIGHT_HIGH = [] {
+            std::array<int8_t, RANK_MASK_COUNT> table{};
+            for (int mask = 0; mask < RANK_MASK_COUNT; ++mask)
+            {
+                table[mask] = -1;
+                for (int high = 12; high >= 4; --high)
+                {
+                    int window = 0x1f << (high - 4);
+                    if ((mask & window) == window)
+                    {
+                        table[mask] = static_cast<int8_t>(high);
+                        break;
+                    }
+                }
+                constexpr int wheel = 0x100f;
+                if (table[mask] < 0 && (mask & wheel) == wheel)
+                    table[mask] = 3;
+            }
+            return table;
+        }();
+
+        /* Top five ranks of a 13-bit rank mask packed as nibbles, highest rank in bits 16..19. */
+        constexpr std::array<uint32_t, RANK_MASK_COUNT> TOP_FIVE = [] {
+            std::array<uint32_t, RANK_MASK_COUNT> table{};
+            for (int mask = 0; mask < RANK_MASK_COUNT; ++mask)
+            {
+                uint32_t packed = 0;
+                int taken = 0;
+                for (int order = 12; order >= 0 && taken < 5; --order)
+                {
+                    if (mask & (1 << order))
+                    {
+                        packed = packed << 4 | order;
+                        ++taken;
+                    }
+                }
+                table[mask] = packed << 4 * (5 - taken);
+            }
+            return table;
+        }();
+
+        /* Top `count` ranks of `mask`, packed as nibbles in the low bits. */
+        inline uint32_t top_ranks(uint32_t mask, int count)
+        {
+            return TOP_FIVE[mask] >> 4 * (5 - count);
+        }
+
+        /* Highest rank of a non-empty mask. Kickers, which small hands may lack, use top_ranks. */
+        inline uint32_t top_rank(uint32_t mask)
+        {
+            return std::bit_width(mask) - 1;
+        }
+
+        inline HandValue make_value(HandCategory category, uint32_t packed_ranks, int rank_count)
+        {
+            return HandValue(static_cast<uint32_t>(category) << 20 | packed_ranks << 4 * (5 - rank_count));
+        }
+
+        /* Per-rank card counts as bit planes: bit r of planes[k] is bit k of the count of rank r. */
+        struct RankCounts
+        {
+            uint32_t planes[3] = {};
+
+            explicit RankCounts(const uint32_t suits[CardSet::SUIT_COUNT])
+            {
+                for (int i = 0; i < CardSet::SUIT_COUNT; ++i)
+                {
+                    uint32_t carry0 = planes[0] & suits[i];
+                    planes[0] ^= suits[i];
+                    uint32_t carry1 = planes[1] & carry0;
+                    planes[1] ^= carry0;
+                    planes[2] |= carry1;
+                }
+            }
+
+            uint32_t four() const { return planes[2]; }
+            uint32_t three() const { return planes[1] & planes[0]; }
+            uint32_t pair() const { return planes[1] & ~planes[0]; }
+        };
+
+        HandValue evaluate_standard(CardSet hand)
+        {
+            uint32_t suits[CardSet::SUIT_COUNT];
+            for (int i = 0; i < CardSet::SUIT_COUNT; ++i)
+                suits[i] = hand.get_suit_ranks(suit_from_order(i));
+
+            HandValue flush;
+            for (uint32_t suit : suits)
+            {
+                if (std::popcount(suit) < 5)
+                    continue;
+
+                int straight_high = STRAIGHT_HIGH[suit];
+                if (straight_high >= 0)
+                    return make_value(HandCategory::StraightFlush, straight_high, 1);
+
+                flush = std::max(flush, make_value(HandCategory::Flush, top_ranks(suit, 5), 5));
+            }
+
+            uint32_t any = suits[0] | suits[1] | suits[2] | suits[3];
+            RankCounts counts(suits);
+
+            if (uint32_t four = counts.four())
+            {
+                uint32_t quad = top_rank(four);
+                return make_value(HandCategory::FourOfAKind, quad << 4 | top_ranks(any & ~(1u << quad), 1), 2);
+            }
+
+            uint32_t three = counts.three();
+            uint32_t pair = counts.pair();
+            if (three)
+            {
+                uint32_t trips = top_rank(three);
+                uint32_t rest = (three & ~(1u << trips)) | pair;
+                if (rest)
+                    return make_value(HandCategory::FullHouse, trips << 4 | top_rank(rest), 2);
+            }
+
+            if (flush.get_value() != 0)
+                return flush;
+
+            int straight_high = STRAIGHT_HIGH[any];
+            if (straight_high >= 0)
+                return make_value(HandCategory::Straight, straight_high, 1);
+
+            if (three)
+            {
+                uint32_t trips = top_rank(three);
+                return make_value(HandCategory::ThreeOfAKind, trips << 8 | top_ranks(any & ~(1u << trips), 2), 3);
+            }
+
+            if (std::popcount(pair) >= 2)
+            {
+                uint32_t pairs = top_ranks(pair, 2);
+                uint32_t used = 1u << (pairs >> 4) | 1u << (pairs & 0xf);
+                return make_value(HandCategory::TwoPair, pairs << 4 | top_ranks(any & ~used, 1), 3);
+            }
+
+            if (pair)
+            {
+                uint32_t pair_rank = top_rank(pair);
+                return make_value(HandCategory::OnePair, pair_rank << 12 | top_ranks(any & ~pair, 3), 4);
+            }
+
+            return make_value(HandCategory::HighCard, top_ranks(any, 5), 5);
+        }
+
+        /*
+         * Replace jokers one at a time. Suits only matter for flushes, so for every rank it is
+         * enough to try the card in the longest suit plus one card in any other suit.
+         */
+        HandValue evaluate_wild(CardSet base, int joker_count)
+        {
+            if (joker_count == 0)
+                return evaluate_standard(base);
+
+            uint32_t suits[CardSet::SUIT_COUNT];
+            for (int i = 0; i < CardSet::SUIT_COUNT; ++i)
+                suits[i] = base.get_suit_ranks(suit_from_order(i));
+
+            RankCounts counts(suits);
+            uint32_t five_candidates = joker_count >= 2 ? counts.four() | counts.three() : counts.four();
+            if (five_candidates)
+                return make_value(HandCategory::FiveOfAKind, top_rank(five_candidates), 1);
+
+            int flush_suit = 0;
+            for (int i = 1; i < CardSet::SUIT_COUNT; ++i)
+            {
+                if (std::popcount(suits[i]) > std::popcount(suits[flush_suit]))
+                    flush_suit = i;
+            }
+
+            HandValue best;
+            for (int order = 0; order < CardSet::RANK_COUNT; ++order)
+            {
+                uint32_t rank_bit = 1u << order;
+                if (!(suits[flush_suit] & rank_bit))
+                {
+                    CardSet substituted(base.get_bits() | uint64_t(1) << (flush_suit * CardSet::RANK_COUNT + order));
+                    best = std::max(best, evaluate_wild(substituted, joker_count - 1));
+                }
+
+                for (int i = 0; i < CardSet::SUIT_COUNT; ++i)
+                {
+                    if (i == flush_suit || (suits[i] & rank_bit))
+                        continue;
+
+                    CardSet substituted(base.get_bits() | uint64_t(1) << (i * CardSet::RANK_COUNT + order));
+                    best = std::max(best, evaluate_wild(substituted, joker_count - 1));
+                    break;
+                }
+            }
+            return best;
+        }
+    }
+
+    HandValue evaluate_hand(CardSet hand)
+    {
+        int joker_count = hand.count_jokers();
+        if (joker_count == 0)
+            return evaluate_standard(hand);
+        return evaluate_wild(hand - CardSet::jokers(), joker_count);
+    }
+
+    void evaluate_hands(std::span<const CardSet> hands, std::span<HandValue> out)
+    {
+        assert(out.size() >= hands.size());
+
+        for (size_t i = 0; i < hands.size(); ++i)
+        {
+            CardSet hand = hands[i];
+            out[i] = hand.count_jokers() == 0 ? evaluate_standard(hand) : evaluate_hand(hand);
+        }
+    }
+
+    void evaluate_hands(std::span<const CardSet> hands, CardSet shared, std::span<HandValue> out)
+    {
+        assert(out.size() >= hands.size());
+
+        for (size_t i = 0; i < hands.size(); ++i)
+        {
+            CardSet hand = hands[i] | shared;
+            out[i] = hand.count_jokers() == 0 ? evaluate_standard(hand) : evaluate_hand(hand);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <span>
+
+#include "logic_core/card_set.h"
+
+namespace logic_core
+{
+    enum class HandCategory : uint8_t
+    {
+        HighCard = 0,
+        OnePair = 1,
+        TwoPair = 2,
+        ThreeOfAKind = 3,
+        Straight = 4,
+        Flush = 5,
+        FullHouse = 6,
+        FourOfAKind = 7,
+        StraightFlush = 8,
+        FiveOfAKind = 9,
+    };
+
+    /*
+     * Strength of the best five-card hand. Values compare directly: a greater value is a
+     * stronger hand and equal values tie. Bits 20..23 hold the category, bits 0..19 hold up
+     * to five rank orders (see rank_order) from the most to the least significant one.
+     */
+    class HandValue
+    {
+    public:
+        constexpr HandValue() = default;
+        constexpr explicit HandValue(uint32_t value) : value(value) {}
+
+        constexpr uint32_t get_value() const { return value; }
+        constexpr HandCategory get_category() const { return static_cast<HandCategory>(value >> 20); }
+
+        constexpr auto operator<=>(const HandValue& other) const = default;
+
+    private:
+        uint32_t value = 0;
+    };
+
+    /*
+     * Score the best five-card hand contained in `hand`. Meant for 5, 6 and 7 cards; smaller
+     * hands are ranked by what they contain. Jokers are wildcards that may stand for any
+     * card, including a fifth card of a rank (FiveOfAKind).
+     */
+    HandValue evaluate_hand(CardSet hand);
+
+    /* Score `hands[i]` into `out[i]`. `out` must be at least as large as `hands`. */
+    void evaluate_hands(std::span<const CardSet> hands, std::span<HandValue> out);
+
+    /* Score `hands[i] | shared` into `out[i]`, e.g. every player's hole cards against one board. */
+    void evaluate_hands(std::span<const CardSet> hands, CardSet shared, std::span<HandValue> out);
+}
@@ -0,0 +1,363 @@
+#include "mcts_player.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "common/random.h"
+#include "common/thread_pool.h"
+
+namespace logic_core
+{
+    struct MctsPlayer::Node
+    {
+        /* Head of the child list; children are prepended with a CAS and never removed. */
+        std::atomic<uint32_t> first_child;
+        uint32_t next_sibling;
+
+        uint16_t placement_code;
+        /* Side that made the move leading here. Rewards are stored from its point of view. */
+        Side mover;
+
+        std::atomic<uint32_t> visits;
+        /* Iterations in which this node's move was possible when its parent was visited. */
+        std::atomic<uint32_t> availability;
+        std::atomic<int32_t> virtual_loss;
+        std::atomic<float> reward_sum;
+    };
+
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        /* Placement codes are 13-bit. */
+        constexpr int PLACEMENT_CODE_COUNT = 1 << 13;
+
+        /* Number of random placements the playout policy compares. */
+        constexpr int PLAYOUT_CANDIDATES = 4;
+
+        int nth_cell(uint64_t mask, uint32_t n)
+        {
+            for (; n > 0; --n)
+                mask &= mask - 1;
+            return std::countr_zero(mask);
+        }
+
+        /* Draw a random card of the deck for the mover, if any is left. */
+        Move with_random_draw(Move move, const Board& board, pf::Xoshiro256& rng)
+        {
+            CardSet deck = board.get_card_deck();
+            if (!deck.empty())
+                move.draw = static_cast<uint8_t>(deck.nth(static_cast<int>(rng.next_below(deck.size()))).to_index());
+            return move;
+        }
+
+        bool is_possible(const Board& board, CardSet cards, const Move& move)
+        {
+            return board.is_block_empty(move.x, move.y) && cards.contains(move.get_card());
+        }
+
+        /* Deal the rival's hidden cards at random, turning the board into a full information state. */
+        void determinize(Board& board, pf::Xoshiro256& rng)
+        {
+            while (board.get_rival_hidden_count() > 0)
+            {
+                CardSet deck = board.get_card_deck();
+                board.reveal_to_rival(deck.nth(static_cast<int>(rng.next_below(deck.size()))));
+            }
+        }
+
+        /* Best immediate score among a few random placements. */
+        void play_out(Board& board, pf::Xoshiro256& rng)
+        {
+            while (!board.is_game_over())
+            {
+                uint64_t empty_cells = board.get_empty_cells();
+                uint32_t cell_count = std::popcount(empty_cells);
+                CardSet cards = board.get_side_cards(board.get_side_to_move());
+
+                Move best_move;
+                int best_score = -1;
+                for (int i = 0; i < PLAYOUT_CANDIDATES; ++i)
+                {
+                    int cell = nth_cell(empty_cells, rng.next_below(cell_count));
+                    Card card = cards.nth(static_cast<int>(rng.next_below(cards.size())));
+                    int score = board.get_placement_score(grid::get_cell_x(cell), grid::get_cell_y(cell), card);
+                    if (score > best_score)
+                    {
+                        best_move = Move::place(grid::get_cell_x(cell), grid::get_cell_y(cell), card);
+                        best_score = score;
+                    }
+                }
+                board.make_move(with_random_draw(best_move, board, rng));
+            }
+        }
+
+        float get_reward(const Board& board, Side side)
+        {
+            int margin = board.get_score(side) - board.get_score(get_opponent(side));
+            return margin > 0 ? 1.0f : margin == 0 ? 0.5f : 0.0f;
+        }
+    }
+
+    MctsPlayer::MctsPlayer(const MctsOptions& options) :
+        options(options),
+        nodes(std::make_unique<Node[]>(options.node_capacity))
+    {
+        assert(options.time_budget.count() > 0 || options.max_iterations > 0);
+        assert(options.node_capacity >= 2);
+        reset();
+    }
+
+    MctsPlayer::~MctsPlayer() = default;
+
+    void MctsPlayer::reset()
+    {
+        /* Index 0 is the null node. */
+        node_count.store(1, std::memory_order_relaxed);
+        root = allocate_node(0, Side::Rival);
+        root_occupancy = 0;
+        root_board_cards.clear();
+    }
+
+    uint32_t MctsPlayer::allocate_node(uint16_t placement_code, Side mover)
+    {
+        uint32_t index = node_count.fetch_add(1, std::memory_order_relaxed);
+        if (index >= options.node_capacity)
+            return 0;
+
+        Node& node = nodes[index];
+        node.first_child.store(0, std::memory_order_relaxed);
+        node.next_sibling = 0;
+        node.placement_code = placement_code;
+        node.mover = mover;
+        node.visits.store(0, std::memory_order_relaxed);
+        node.availability.store(1, std::memory_order_relaxed);
+        node.virtual_loss.store(0, std::memory_order_relaxed);
+        node.reward_sum.store(0.0f, std::memory_order_relaxed);
+        return index;
+    }
+
+    uint32_t MctsPlayer::find_child(uint32_t parent, uint16_t placement_code) const
+    {
+        for (uint32_t child = nodes[parent].first_child.load(std::memory_order_acquire); child; child = nodes[child].next_sibling)
+        {
+            if (nodes[child].placement_code == placement_code)
+                return child;
+        }
+        return 0;
+    }
+
+    Move MctsPlayer::choose_move(const Board& board)
+    {
+        assert(board.get_side_to_move() == Side::Player && !board.is_game_over());
+
+        bool is_same_position = board.get_occupancy() == root_occupancy && board.get_board_cards() == root_board_cards;
+        if (!root || !is_same_position || node_count.load(std::memory_order_relaxed) > options.node_capacity / 2)
+        {
+            reset();
+            root_occupancy = board.get_occupancy();
+            root_board_cards = board.get_board_cards();
+        }
+
+        stats.reused_visits = nodes[root].visits.load(std::memory_order_relaxed);
+        iteration_count.store(0, std::memory_order_relaxed);
+        deadline = Clock::now() + options.time_budget;
+
+        ++search_count;
+        if (options.thread_count == 1)
+        {
+            run_iterations(board, 0);
+        }
+        else
+        {
+            pf::ThreadPool& thread_pool = options.thread_pool ? *options.thread_pool : pf::ThreadPool::get_shared();
+            unsigned thread_count = options.thread_count ? options.thread_count : thread_pool.get_thread_count();
+            thread_pool.parallel_for(thread_count, [&](size_t i) {
+                run_iterations(board, static_cast<uint32_t>(i));
+            });
+        }
+
+        stats.iterations = iteration_count.load(std::memory_order_relaxed);
+        stats.node_count = std::min(node_count.load(std::memory_order_relaxed), options.node_capacity);
+
+        /* The most visited placement that is possible with the cards actually held. */
+        CardSet cards = board.get_hand_cards();
+        Move best_move;
+        uint32_t best_visits = 0;
+        for (uint32_t child = nodes[root].first_child.load(std::memory_order_acquire); child; child = nodes[child].next_sibling)
+        {
+            Move move = Move::from_placement_code(nodes[child].placement_code);
+            uint32_t visits = nodes[child].visits.load(std::memory_order_relaxed);
+            if (visits > best_visits && is_possible(board, cards, move))
+            {
+                best_move = move;
+                best_visits = visits;
+            }
+        }
+
+        if (best_visits == 0)
+        {
+            int cell = std::countr_zero(board.get_empty_cells());
+            best_move = Move::place(grid::get_cell_x(cell), grid::get_cell_y(cell), cards.front());
+        }
+        return best_move;
+    }
+
+    void MctsPlayer::advance(const Move& move)
+    {
+        root_occupancy |= grid::get_cell_bit(grid::get_cell(move.x, move.y));
+        root_board_cards.insert(move.get_card());
+        if (root)
+            root = find_child(root, move.get_placement_code());
+    }
+
+    void MctsPlayer::run_iterations(const Board& root_board, uint32_t worker_index)
+    {
+        pf::Xoshiro256 rng(pf::mix_seed(options.seed, search_count * 1024 + worker_index));
+
+        /* seen[code] == stamp marks the placements that already have a node at the current level. */
+        std::vector<uint32_t> seen(PLACEMENT_CODE_COUNT, 0);
+        uint32_t stamp = 0;
+
+        std::vector<Move> moves;
+        uint32_t path[grid::MAX_CELLS + 1];
+
+        while (true)
+        {
+            if (options.max_iterations && iteration_count.load(std::memory_order_relaxed) >= options.max_iterations)
+                break;
+            if (options.time_budget.count() > 0 && Clock::now() >= deadline)
+                break;
+            if (node_count.load(std::memory_order_relaxed) >= options.node_capacity)
+                break;
+            iteration_count.fetch_add(1, std::memory_order_relaxed);
+
+            Board board = root_board;
+            determinize(board, rng);
+
+            int path_size = 0;
+            path[path_size++] = root;
+            uint32_t node = root;
+
+            /* Selection and expansion. */
+            while (!board.is_game_over())
+            {
+                CardSet cards = board.get_side_cards(board.get_side_to_move());
+                int move_count = std::popcount(board.get_empty_cells()) * cards.size();
+
+                ++stamp;
+                int known_count = 0;
+                uint32_t best_child = 0;
+                float best_value = -1.0f;
+                uint32_t selection_head = nodes[node].first_child.load(std::memory_order_acquire);
+                for (uint32_t child = selection_head; child; child = nodes[child].next_sibling)
+                {
+                    Node& child_node = nodes[child];
+                    if (!is_possible(board, cards, Move::from_placement_code(child_node.placement_code)))
+                        continue;
+
+                    seen[child_node.placement_code] = stamp;
+                    ++known_count;
+
+                    uint32_t availability = child_node.availability.fetch_add(1, std::memory_order_relaxed) + 1;
+                    float visits = static_cast<float>(child_node.visits.load(std::memory_order_relaxed) +
+                        child_node.virtual_loss.load(std::memory_order_relaxed));
+                    float value = visits == 0.0f ? INFINITY :
+                        child_node.reward_sum.load(std::memory_order_relaxed) / visits +
+                        options.exploration * std::sqrt(std::log(static_cast<float>(availability)) / visits);
+                    if (value > best_value)
+                    {
+                        best_child = child;
+                        best_value = value;
+                    }
+                }
+
+                if (known_count < move_count)
+                {
+                    /* Expand the best scoring placement that has no node yet, ties broken at random. */
+                    moves.resize(board.get_move_capacity());
+                    int count = board.generate_moves(moves);
+                    Move move;
+                    int best_score = -1;
+                    uint32_t tie_count = 0;
+                    for (int i = 0; i < count; ++i)
+                    {
+                        if (seen[moves[i].get_placement_code()] == stamp)
+                            continue;
+
+                        int score = board.get_placement_score(moves[i].x, moves[i].y, moves[i].get_card());
+                        if (score > best_score)
+                        {
+                            move = moves[i];
+                            best_score = score;
+                            tie_count = 1;
+                        }
+                        else if (score == best_score && rng.next_below(++tie_count) == 0)
+                        {
+                            move = moves[i];
+                        }
+                    }
+                    uint16_t code = move.get_placement_code();
+
+                    uint32_t child = allocate_node(code, board.get_side_to_move());
+                    if (!child)
+                        break;
+
+                    /* Another thread may have added the same placement since selection read the list;
+                       use its node then. Only children pushed after selection_head need checking. */
+                    std::atomic<uint32_t>& head = nodes[node].first_child;
+                    uint32_t expected = head.load(std::memory_order_acquire);
+                    uint32_t known_head = selection_head;
+                    while (true)
+                    {
+                        uint32_t twin = 0;
+                        for (uint32_t other = expected; other != known_head; other = nodes[other].next_sibling)
+                        {
+                            if (nodes[other].placement_code == code)
+                                twin = other;
+                        }
+                        if (twin)
+                        {
+                            /* Our node was never linked; hand it back unless another allocation followed it,
+                               in which case it stays unused until the tree is reset. */
+                            uint32_t next_index = child + 1;
+                            node_count.compare_exchange_strong(next_index, child, std::memory_order_relaxed);
+                            child = twin;
+                            break;
+                        }
+
+                        nodes[child].next_sibling = expected;
+                        known_head = expected;
+                        if (head.compare_exchange_weak(expected, child, std::memory_order_release, std::memory_order_acquire))
+                            break;
+                    }
+
+                    nodes[child].virtual_loss.fetch_add(1, std::memory_order_relaxed);
+                    path[path_size++] = child;
+                    board.make_move(with_random_draw(move, board, rng));
+                    break;
+                }
+
+                nodes[best_child].virtual_loss.fetch_add(1, std::memory_order_relaxed);
+                path[path_size++] = best_child;
+                board.make_move(with_random_draw(Move::from_placement_code(nodes[best_child].placement_code), board, rng));
+                node = best_child;
+            }
+
+            play_out(board, rng);
+
+            float player_reward = get_reward(board, Side::Player);
+            for (int i = 0; i < path_size; ++i)
+            {
+                Node& path_node = nodes[path[i]];
+                if (i > 0)
+                    path_node.virtual_loss.fetch_sub(1, std::memory_order_relaxed);
+                path_node.reward_sum.fetch_add(path_node.mover == Side::Player ? player_reward : 1.0f - player_reward, std::memory_order_relaxed);
+                path_node.visits.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+}
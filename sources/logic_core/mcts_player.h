@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "logic_core/board.h"
+#include "logic_core/move.h"
+
+namespace pf
+{
+    class ThreadPool;
+}
+
+namespace logic_core
+{
+    struct MctsOptions
+    {
+        /* Wall clock budget of one choose_move() call. Zero for none; then max_iterations must be set. */
+        std::chrono::microseconds time_budget{ 20000 };
+        /* Iteration budget of one choose_move() call, zero for none. */
+        uint64_t max_iterations = 0;
+
+        /* Nodes preallocated for the tree. Search stops early when they run out. */
+        uint32_t node_capacity = 1 << 20;
+
+        /* UCB exploration constant. */
+        float exploration = 0.7f;
+
+        uint64_t seed = 0;
+
+        /* Pool to search on, ThreadPool::get_shared() when null. */
+        pf::ThreadPool* thread_pool = nullptr;
+        /*
+         * Threads growing the tree, every thread of the pool when 0. With 1 the search runs
+         * on the calling thread only and an iteration budget makes it reproducible.
+         */
+        unsigned thread_count = 0;
+    };
+
+    struct MctsStats
+    {
+        uint64_t iterations = 0;
+        uint32_t node_count = 0;
+        /* Visits of the root that were kept from the previous turns. */
+        uint32_t reused_visits = 0;
+    };
+
+    /*
+     * Computer opponent using single observer information set Monte Carlo tree search. The
+     * board passed to choose_move() is the computer's own view: it moves as Side::Player and
+     * the human's cards are the hidden rival cards. Every iteration deals the hidden cards and
+     * the draws at random and then descends one shared tree whose nodes are placements,
+     * skipping placements that are not possible in that deal.
+     *
+     * All threads of the pool grow the same tree. Nodes under evaluation carry a virtual loss
+     * so concurrent iterations spread out, and child lists are extended with a CAS so no lock
+     * is taken. Nodes come from a preallocated pool with a bump index and are never freed one
+     * by one; the pool is recycled when a new search would start with it more than half full.
+     *
+     * Report every move that is actually played, including the computer's own, with advance()
+     * so the subtree of the new position is kept for the next search.
+     */
+    class MctsPlayer
+    {
+    public:
+        explicit MctsPlayer(const MctsOptions& options = MctsOptions());
+        ~MctsPlayer();
+
+        MctsPlayer(const MctsPlayer&) = delete;
+        MctsPlayer& operator=(const MctsPlayer&) = delete;
+
+        /* Best placement for the side to move, which must be Side::Player. The game must not be over. */
+        Move choose_move(const Board& board);
+
+        /* Move the root down along a played move, dropping the tree if it was not explored. */
+        void advance(const Move& move);
+
+        /* Drop the whole tree. */
+        void reset();
+
+        const MctsStats& get_stats() const { return stats; }
+
+    private:
+        struct Node;
+
+        uint32_t allocate_node(uint16_t placement_code, Side mover);
+        uint32_t find_child(uint32_t parent, uint16_t placement_code) const;
+        void run_iterations(const Board& root_board, uint32_t worker_index);
+
+        MctsOptions options;
+        std::unique_ptr<Node[]> nodes;
+        std::atomic<uint32_t> node_count = 0;
+        uint32_t root = 0;
+
+        /* Grid of the position the root stands for, to notice boards that do not follow the tree. */
+        uint64_t root_occupancy = 0;
+        CardSet root_board_cards;
+
+        uint64_t search_count = 0;
+        std::atomic<uint64_t> iteration_count = 0;
+        std::chrono::steady_clock::time_point deadline;
+        MctsStats stats;
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include "logic_core/card.h"
+
+namespace logic_core
+{
+    enum class Side : uint8_t
+    {
+        Player = 0,
+        Rival = 1,
+    };
+
+    constexpr Side get_opponent(Side side)
+    {
+        return side == Side::Player ? Side::Rival : Side::Player;
+    }
+
+    /*
+     * One turn: put `card` on block (x, y), then move `draw` from the deck to the mover's
+     * cards. `draw` is NO_DRAW when the deck is empty, and HIDDEN_DRAW when the rival draws
+     * a card the local player does not get to see. Cards are stored as Card::to_index() so
+     * a move fits in four bytes.
+     */
+    struct Move
+    {
+        static constexpr uint8_t NO_DRAW = 0xff;
+        static constexpr uint8_t HIDDEN_DRAW = 0xfe;
+
+        uint8_t x = 0;
+        uint8_t y = 0;
+        uint8_t card = 0;
+        uint8_t draw = NO_DRAW;
+
+        static constexpr Move place(int x, int y, const Card& card)
+        {
+            return Move{ static_cast<uint8_t>(x), static_cast<uint8_t>(y), static_cast<uint8_t>(card.to_index()), NO_DRAW };
+        }
+
+        constexpr Card get_card() const { return Card::from_index(card); }
+        constexpr bool has_draw() const { return draw != NO_DRAW && draw != HIDDEN_DRAW; }
+        constexpr bool has_hidden_draw() const { return draw == HIDDEN_DRAW; }
+        constexpr Card get_draw() const { return Card::from_index(draw); }
+
+        /* Non-zero 13-bit code of the placement without the draw, e.g. for TranspositionEntry::move. */
+        constexpr uint16_t get_placement_code() const
+        {
+            return static_cast<uint16_t>((x | y << 3 | card << 6) + 1);
+        }
+
+        static constexpr Move from_placement_code(uint16_t code)
+        {
+            --code;
+            return Move{ static_cast<uint8_t>(code & 7), static_cast<uint8_t>(code >> 3 & 7), static_cast<uint8_t>(code >> 6), NO_DRAW };
+        }
+
+        constexpr bool operator==(const Move& other) const = default;
+    };
+
+    static_assert(sizeof(Move) == 4);
+}
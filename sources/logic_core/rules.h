@@ -0,0 +1,34 @@
+#pragma once
+
+#include "logic_core/hand_evaluator.h"
+
+namespace logic_core
+{
+    /*
+     * Scoring rules. A line is LINE_LENGTH consecutive blocks in a row, a column or a
+     * diagonal. The side whose placement fills the last block of a line scores the poker
+     * hand formed by the line's cards.
+     */
+    constexpr int LINE_LENGTH = 5;
+
+    /* Cards each side holds at the start of a game. */
+    constexpr int STARTING_HAND_SIZE = 5;
+
+    constexpr int get_line_score(HandCategory category)
+    {
+        switch (category)
+        {
+        case HandCategory::HighCard: return 0;
+        case HandCategory::OnePair: return 2;
+        case HandCategory::TwoPair: return 5;
+        case HandCategory::ThreeOfAKind: return 10;
+        case HandCategory::Straight: return 15;
+        case HandCategory::Flush: return 20;
+        case HandCategory::FullHouse: return 25;
+        case HandCategory::FourOfAKind: return 50;
+        case HandCategory::StraightFlush: return 75;
+        case HandCategory::FiveOfAKind: return 100;
+        }
+        return 0;
+    }
+}
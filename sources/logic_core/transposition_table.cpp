@@ -0,0 +1,114 @@
+#include "transposition_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace logic_core
+{
+    /* Payload layout: value bits 0..31, depth 32..39, bound 40..41, generation 42..47, move 48..63. */
+    uint64_t TranspositionTable::pack(const TranspositionEntry& entry, uint8_t generation)
+    {
+        return uint64_t(std::bit_cast<uint32_t>(entry.value)) |
+            uint64_t(static_cast<uint8_t>(entry.depth)) << 32 |
+            uint64_t(static_cast<uint8_t>(entry.bound) & 0x3) << 40 |
+            uint64_t(generation & 0x3f) << 42 |
+            uint64_t(entry.move) << 48;
+    }
+
+    TranspositionEntry TranspositionTable::unpack(uint64_t data)
+    {
+        TranspositionEntry entry;
+        entry.value = std::bit_cast<float>(static_cast<uint32_t>(data));
+        entry.depth = get_depth(data);
+        entry.bound = static_cast<BoundType>(data >> 40 & 0x3);
+        entry.move = static_cast<uint16_t>(data >> 48);
+        return entry;
+    }
+
+    TranspositionTable::TranspositionTable(size_t size_in_bytes)
+    {
+        size_t bucket_count = std::bit_floor(std::max<size_t>(1, size_in_bytes / sizeof(Bucket)));
+        buckets = std::make_unique<Bucket[]>(bucket_count);
+        bucket_mask = bucket_count - 1;
+        clear();
+    }
+
+    bool TranspositionTable::probe(uint64_t key, TranspositionEntry& out_entry) const
+    {
+        Bucket& bucket = get_bucket(key);
+        for (Slot& slot : bucket.slots)
+        {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            uint64_t check = slot.check.load(std::memory_order_relaxed);
+            if ((check ^ data) != key)
+                continue;
+
+            TranspositionEntry entry = unpack(data);
+            if (entry.bound == BoundType::None)
+                continue;
+
+            out_entry = entry;
+            return true;
+        }
+        return false;
+    }
+
+    void TranspositionTable::store(uint64_t key, const TranspositionEntry& entry)
+    {
+        assert(entry.bound != BoundType::None);
+
+        uint8_t current_generation = generation.load(std::memory_order_relaxed) & 0x3f;
+        Bucket& bucket = get_bucket(key);
+
+        Slot* victim = nullptr;
+        int victim_score = INT32_MAX;
+        for (Slot& slot : bucket.slots)
+        {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+            if ((check ^ data) == key)
+            {
+                /* Same position: keep the deeper result unless it is stale. */
+                if (entry.depth < get_depth(data) && get_generation(data) == current_generation)
+                    return;
+                victim = &slot;
+                break;
+            }
+
+            int score = get_depth(data);
+            if (data == 0)
+                score = INT32_MIN;
+            else if (get_generation(data) == current_generation)
+                score += 256;
+
+            if (score < victim_score)
+            {
+                victim = &slot;
+                victim_score = score;
+            }
+        }
+
+        uint64_t data = pack(entry, current_generation);
+        victim->data.store(data, std::memory_order_relaxed);
+        victim->check.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::new_generation()
+    {
+        generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::clear()
+    {
+        for (size_t i = 0; i <= bucket_mask; ++i)
+        {
+            for (Slot& slot : buckets[i].slots)
+            {
+                slot.data.store(0, std::memory_order_relaxed);
+                slot.check.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
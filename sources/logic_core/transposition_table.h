@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace logic_core
+{
+    enum class BoundType : uint8_t
+    {
+        None = 0,
+        Exact = 1,
+        Lower = 2,
+        Upper = 3,
+    };
+
+    struct TranspositionEntry
+    {
+        float value = 0.f;
+        /* Search depth (or effort) behind the value. Deeper entries survive replacement. */
+        int8_t depth = 0;
+        BoundType bound = BoundType::None;
+        /* Encoded best move, 0 for none. */
+        uint16_t move = 0;
+    };
+
+    /*
+     * Fixed-size hash table of search results keyed by Board::get_hash(), shared by any
+     * number of threads without locks. Each slot stores the key xor-ed with its payload
+     * next to the payload itself; a reader that sees a half written slot gets a key
+     * mismatch and treats it as a miss.
+     *
+     * Buckets hold four slots in one cache line. A store replaces the entry of the same
+     * key, else an empty slot, else the shallowest entry, preferring entries left over from
+     * older generations.
+     */
+    class TranspositionTable
+    {
+    public:
+        /* Use about `size_in_bytes` of memory, rounded down to a power of two of buckets. */
+        explicit TranspositionTable(size_t size_in_bytes);
+
+        bool probe(uint64_t key, TranspositionEntry& out_entry) const;
+        void store(uint64_t key, const TranspositionEntry& entry);
+
+        /* Age all entries, e.g. once per turn, so stale results give way first. */
+        void new_generation();
+        void clear();
+
+        size_t get_capacity() const { return (bucket_mask + 1) * BUCKET_SIZE; }
+
+    private:
+        static constexpr int BUCKET_SIZE = 4;
+
+        struct Slot
+        {
+            std::atomic<uint64_t> check;
+            std::atomic<uint64_t> data;
+        };
+
+        struct alignas(64) Bucket
+        {
+            Slot slots[BUCKET_SIZE];
+        };
+
+        static uint64_t pack(const TranspositionEntry& entry, uint8_t generation);
+        static TranspositionEntry unpack(uint64_t data);
+        static uint8_t get_generation(uint64_t data) { return static_cast<uint8_t>(data >> 42 & 0x3f); }
+        static int8_t get_depth(uint64_t data) { return static_cast<int8_t>(data >> 32 & 0xff); }
+
+        Bucket& get_bucket(uint64_t key) const { return buckets[key & bucket_mask]; }
+
+        std::unique_ptr<Bucket[]> buckets;
+        size_t bucket_mask;
+        std::atomic<uint8_t> generation = 0;
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "common/random.h"
+#include "logic_core/card.h"
+
+namespace logic_core::zobrist
+{
+    /* Boards are at most MAX_WIDTH x MAX_HEIGHT blocks. Cell keys are indexed by y * MAX_WIDTH + x. */
+    constexpr int MAX_WIDTH = 8;
+    constexpr int MAX_HEIGHT = 8;
+    constexpr int MAX_CELLS = MAX_WIDTH * MAX_HEIGHT;
+
+    /* Places a card can be in besides the grid. */
+    enum class Location : uint8_t
+    {
+        Hand = 0,
+        Rival = 1,
+        Deck = 2,
+    };
+
+    namespace detail
+    {
+        constexpr uint64_t SEED = 0x5eed'70b3'c0de'cafeull;
+
+        template<size_t Count>
+        constexpr std::array<uint64_t, Count> make_keys(uint64_t stream)
+        {
+            pf::SplitMix64 generator(pf::mix_seed(SEED, stream));
+            std::array<uint64_t, Count> keys{};
+            for (uint64_t& key : keys)
+                key = generator.next();
+            return keys;
+        }
+
+        constexpr auto CELL_KEYS = make_keys<MAX_CELLS * Card::INDEX_COUNT>(0);
+        constexpr auto LOCATION_KEYS = make_keys<3 * Card::INDEX_COUNT>(1);
+        constexpr auto MISC_KEYS = make_keys<1>(2);
+        constexpr auto HIDDEN_COUNT_KEYS = make_keys<Card::INDEX_COUNT + 1>(3);
+    }
+
+    /* Key of `card_index` lying on block (x, y). */
+    constexpr uint64_t cell_key(int x, int y, int card_index)
+    {
+        return detail::CELL_KEYS[(y * MAX_WIDTH + x) * Card::INDEX_COUNT + card_index];
+    }
+
+    /* Key of `card_index` being held in `location`. */
+    constexpr uint64_t location_key(Location location, int card_index)
+    {
+        return detail::LOCATION_KEYS[static_cast<int>(location) * Card::INDEX_COUNT + card_index];
+    }
+
+    /* Toggled whenever the side to move changes. */
+    constexpr uint64_t side_key()
+    {
+        return detail::MISC_KEYS[0];
+    }
+
+    /* Key of the rival holding `count` hidden cards. */
+    constexpr uint64_t hidden_count_key(int count)
+    {
+        return detail::HIDDEN_COUNT_KEYS[count];
+    }
+}
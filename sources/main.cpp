@@ -1,4 +1,12 @@
 #include <SDL3/SDL.h>
+
+#include <memory>
+
+#include "data/binary_font_data.h"
+#include "data/binary_text_data.h"
+#include "io/asset_loader.h"
+#include "io/pack_reader.h"
+#include "presenter/renderer/renderer_software.h"
 /*
  * SDL3/SDL_main.h is explicitly not included such that a terminal window would appear on Windows.
  */
@@ -21,13 +29,48 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    bool is_running = false;
+    /* The scene is rasterized on the CPU and streamed to the window through a texture. */
+    SDL_Texture *frame_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, 640, 480);
+    if (frame_texture == NULL) {
+        SDL_Log("SDL_CreateTexture failed (%s)", SDL_GetError());
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 1;
+    }
+    presenter::Renderer_Software scene_renderer(pf_math::Rect{ 0.f, 0.f, 640.f, 480.f },
+        [renderer, frame_texture](const uint32_t *pixels, int width, int height, int pitch) {
+            SDL_Rect rect = { 0, 0, width, height };
+            SDL_UpdateTexture(frame_texture, &rect, pixels, pitch);
+            SDL_RenderTexture(renderer, frame_texture, NULL, NULL);
+        });
+    scene_renderer.set_clear_color(80, 80, 80);
+
+    /* Resources load in the background; the first frames are drawn without them. */
+    auto pack = std::make_shared<const pf_io::PackReader>("resources.pfpk");
+    pf_io::AssetLoader asset_loader(pack);
+    pf_io::AssetHandle<pf::BinaryFontData> font = asset_loader.load<pf::BinaryFontData>("font", 100,
+        [](pf_io::BinaryReader& reader, pf::BinaryFontData& out_font) { return out_font.load(reader); },
+        [](const pf_io::AssetHandle<pf::BinaryFontData>& handle) {
+            if (!handle.is_ready()) {
+                SDL_Log("Loading the font failed");
+            }
+        });
+    pf_io::AssetHandle<pf::BinaryTextData> texts = asset_loader.load<pf::BinaryTextData>("text", 100,
+        [](pf_io::BinaryReader& reader, pf::BinaryTextData& out_texts) { return out_texts.load(reader); },
+        [](const pf_io::AssetHandle<pf::BinaryTextData>& handle) {
+            if (!handle.is_ready()) {
+                SDL_Log("Loading the text table failed");
+            }
+        });
+
+    bool is_running = true;
 
     while (is_running) {
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_EVENT_QUIT) {
-                is_running = true;
+                is_running = false;
                 break;
             }
         }
@@ -35,11 +78,14 @@ int main(int argc, char *argv[]) {
             break;
         }
 
-        SDL_SetRenderDrawColor(renderer, 80, 80, 80, SDL_ALPHA_OPAQUE);
-        SDL_RenderClear(renderer);
+        asset_loader.pump();
+
+        scene_renderer.prepare();
+        scene_renderer.present();
         SDL_RenderPresent(renderer);
     }
 
+    SDL_DestroyTexture(frame_texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
 
@@ -0,0 +1,161 @@
+#include "bit_expand.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace presenter
+{
+    namespace
+    {
+        bool get_bit(const uint8_t* bits, size_t index)
+        {
+            return (bits[index >> 3] >> (7 - (index & 7))) & 1;
+        }
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+        /*
+         * `byte_count` bytes' worth of bits starting at bit `index`, most significant first, as
+         * if the bitmap started there. Reads only the bytes holding those bits.
+         */
+        uint64_t read_window(const uint8_t* bits, size_t index, int byte_count)
+        {
+            const uint8_t* bytes = bits + (index >> 3);
+            int shift = static_cast<int>(index & 7);
+            uint64_t window = 0;
+            for (int i = 0; i < byte_count; ++i)
+                window = window << 8 | bytes[i];
+            window = shift ? (window << 8 | bytes[byte_count]) << shift >> 8 : window;
+            return window & ((uint64_t(1) << (8 * byte_count)) - 1);
+        }
+
+        /* Byte i selects bit 7 - i % 8, matching most significant bit first order. */
+        __m128i get_bit_mask_128()
+        {
+            return _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        }
+
+        /* 0xff for every set bit of a 16-bit window, 0 for clear ones. */
+        __m128i expand_16(uint64_t window, __m128i bit_mask)
+        {
+            __m128i spread = _mm_unpacklo_epi64(_mm_set1_epi8(static_cast<char>(window >> 8)), _mm_set1_epi8(static_cast<char>(window)));
+            return _mm_cmpeq_epi8(_mm_and_si128(spread, bit_mask), bit_mask);
+        }
+#endif
+
+#if defined(__AVX2__)
+        /* 0xff for every set bit of a 32-bit window, 0 for clear ones. */
+        __m256i expand_32(uint64_t window, __m256i bit_mask)
+        {
+            /* The window's most significant byte is byte 3 of the little endian broadcast. */
+            static const __m256i spread_index = _mm256_setr_epi8(
+                3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2,
+                1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0);
+            __m256i spread = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(window)), spread_index);
+            return _mm256_cmpeq_epi8(_mm256_and_si256(spread, bit_mask), bit_mask);
+        }
+#endif
+    }
+
+    void expand_bits_a8_scalar(const uint8_t* bits, size_t first_bit, size_t count, uint8_t* out_pixels, uint8_t alpha)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out_pixels[i] = get_bit(bits, first_bit + i) ? alpha : 0;
+    }
+
+    void expand_bits_rgba8_scalar(const uint8_t* bits, size_t first_bit, size_t count, uint32_t* out_pixels, uint32_t color)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out_pixels[i] = get_bit(bits, first_bit + i) ? color : 0;
+    }
+
+    void expand_bits_a8(const uint8_t* bits, size_t first_bit, size_t count, uint8_t* out_pixels, uint8_t alpha)
+    {
+        size_t done = 0;
+#if defined(__AVX2__)
+        __m256i bit_mask = _mm256_broadcastsi128_si256(get_bit_mask_128());
+        __m256i alpha_32 = _mm256_set1_epi8(static_cast<char>(alpha));
+        for (; count - done >= 32; done += 32)
+        {
+            __m256i mask = expand_32(read_window(bits, first_bit + done, 4), bit_mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_pixels + done), _mm256_and_si256(mask, alpha_32));
+        }
+#endif
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+        __m128i bit_mask_16 = get_bit_mask_128();
+        __m128i alpha_16 = _mm_set1_epi8(static_cast<char>(alpha));
+        for (; count - done >= 16; done += 16)
+        {
+            __m128i mask = expand_16(read_window(bits, first_bit + done, 2), bit_mask_16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out_pixels + done), _mm_and_si128(mask, alpha_16));
+        }
+        if (count - done >= 8)
+        {
+            __m128i mask = expand_16(read_window(bits, first_bit + done, 1) << 8, bit_mask_16);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out_pixels + done), _mm_and_si128(mask, alpha_16));
+            done += 8;
+        }
+#endif
+        expand_bits_a8_scalar(bits, first_bit + done, count - done, out_pixels + done, alpha);
+    }
+
+    void expand_bits_rgba8(const uint8_t* bits, size_t first_bit, size_t count, uint32_t* out_pixels, uint32_t color)
+    {
+        size_t done = 0;
+#if defined(__AVX2__)
+        /* Sign extension turns every 0xff mask byte into a 0xffffffff pixel mask. */
+        __m256i bit_mask = _mm256_broadcastsi128_si256(get_bit_mask_128());
+        __m256i color_8 = _mm256_set1_epi32(static_cast<int>(color));
+        for (; count - done >= 32; done += 32)
+        {
+            __m256i mask = expand_32(read_window(bits, first_bit + done, 4), bit_mask);
+            __m128i low = _mm256_castsi256_si128(mask);
+            __m128i high = _mm256_extracti128_si256(mask, 1);
+            __m256i* out = reinterpret_cast<__m256i*>(out_pixels + done);
+            _mm256_storeu_si256(out + 0, _mm256_and_si256(_mm256_cvtepi8_epi32(low), color_8));
+            _mm256_storeu_si256(out + 1, _mm256_and_si256(_mm256_cvtepi8_epi32(_mm_srli_si128(low, 8)), color_8));
+            _mm256_storeu_si256(out + 2, _mm256_and_si256(_mm256_cvtepi8_epi32(high), color_8));
+            _mm256_storeu_si256(out + 3, _mm256_and_si256(_mm256_cvtepi8_epi32(_mm_srli_si128(high, 8)), color_8));
+        }
+        for (; count - done >= 16; done += 16)
+        {
+            __m128i mask = expand_16(read_window(bits, first_bit + done, 2), get_bit_mask_128());
+            __m256i* out = reinterpret_cast<__m256i*>(out_pixels + done);
+            _mm256_storeu_si256(out + 0, _mm256_and_si256(_mm256_cvtepi8_epi32(mask), color_8));
+            _mm256_storeu_si256(out + 1, _mm256_and_si256(_mm256_cvtepi8_epi32(_mm_srli_si128(mask, 8)), color_8));
+        }
+        if (count - done >= 8)
+        {
+            __m128i mask = expand_16(read_window(bits, first_bit + done, 1) << 8, get_bit_mask_128());
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_pixels + done), _mm256_and_si256(_mm256_cvtepi8_epi32(mask), color_8));
+            done += 8;
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        __m128i bit_mask = get_bit_mask_128();
+        __m128i color_4 = _mm_set1_epi32(static_cast<int>(color));
+        for (; count - done >= 16; done += 16)
+        {
+            __m128i mask = expand_16(read_window(bits, first_bit + done, 2), bit_mask);
+            __m128i low = _mm_unpacklo_epi8(mask, mask);
+            __m128i high = _mm_unpackhi_epi8(mask, mask);
+            __m128i* out = reinterpret_cast<__m128i*>(out_pixels + done);
+            _mm_storeu_si128(out + 0, _mm_and_si128(_mm_unpacklo_epi16(low, low), color_4));
+            _mm_storeu_si128(out + 1, _mm_and_si128(_mm_unpackhi_epi16(low, low), color_4));
+            _mm_storeu_si128(out + 2, _mm_and_si128(_mm_unpacklo_epi16(high, high), color_4));
+            _mm_storeu_si128(out + 3, _mm_and_si128(_mm_unpackhi_epi16(high, high), color_4));
+        }
+        if (count - done >= 8)
+        {
+            __m128i mask = expand_16(read_window(bits, first_bit + done, 1) << 8, bit_mask);
+            __m128i low = _mm_unpacklo_epi8(mask, mask);
+            __m128i* out = reinterpret_cast<__m128i*>(out_pixels + done);
+            _mm_storeu_si128(out + 0, _mm_and_si128(_mm_unpacklo_epi16(low, low), color_4));
+            _mm_storeu_si128(out + 1, _mm_and_si128(_mm_unpackhi_epi16(low, low), color_4));
+            done += 8;
+        }
+#endif
+        expand_bits_rgba8_scalar(bits, first_bit + done, count - done, out_pixels + done, color);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace presenter
+{
+    /*
+     * Expand `count` bits of a most significant bit first bitmap, starting at bit `first_bit`,
+     * to one pixel per bit: `alpha` for a set bit and 0 for a clear one. This is the layout of
+     * BinaryFontData glyphs, whose rows follow each other without byte alignment.
+     *
+     * Uses AVX2 or SSE2 when the build targets them; the _scalar versions are the reference.
+     */
+    void expand_bits_a8(const uint8_t* bits, size_t first_bit, size_t count, uint8_t* out_pixels, uint8_t alpha);
+    void expand_bits_a8_scalar(const uint8_t* bits, size_t first_bit, size_t count, uint8_t* out_pixels, uint8_t alpha);
+
+    /* Same to 32-bit pixels: `color` for a set bit and 0, transparent black, for a clear one. */
+    void expand_bits_rgba8(const uint8_t* bits, size_t first_bit, size_t count, uint32_t* out_pixels, uint32_t color);
+    void expand_bits_rgba8_scalar(const uint8_t* bits, size_t first_bit, size_t count, uint32_t* out_pixels, uint32_t color);
+}
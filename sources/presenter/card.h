@@ -1,7 +1,12 @@
+#pragma once
+
+#include "presenter/presentable_object.h"
+
 namespace presenter
 {
-    class Card
+    class Card : public PresentableObject
     {
-
+    public:
+        using PresentableObject::PresentableObject;
     };
-}
\ No newline at end of file
+}
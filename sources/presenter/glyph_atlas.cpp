@@ -0,0 +1,202 @@
+#include "glyph_atlas.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+#include "presenter/bit_expand.h"
+
+namespace presenter
+{
+    GlyphAtlas::GlyphAtlas(const pf::BinaryFontData& font, int width, int height) :
+        font(font),
+        width(width),
+        height(height),
+        pixels(static_cast<size_t>(width) * height),
+        pages(PAGE_COUNT)
+    {
+        assert(width > 0 && width <= UINT16_MAX && height > 0 && height <= UINT16_MAX);
+    }
+
+    uint16_t& GlyphAtlas::get_entry(uint32_t codepoint)
+    {
+        auto& page = pages[codepoint / PAGE_SIZE];
+        if (!page)
+            page = std::make_unique<std::array<uint16_t, PAGE_SIZE>>();
+        return (*page)[codepoint % PAGE_SIZE];
+    }
+
+    const GlyphRegion* GlyphAtlas::find_glyph(uint32_t codepoint)
+    {
+        if (codepoint >= PAGE_COUNT * PAGE_SIZE)
+            return nullptr;
+
+        uint16_t& entry = get_entry(codepoint);
+        if (entry == MISSING_GLYPH)
+            return nullptr;
+        if (entry == 0)
+            return add_glyph(codepoint, entry);
+
+        Slot& slot = slots[entry - 1];
+        touch(slot);
+        return &slot.region;
+    }
+
+    bool GlyphAtlas::prepare_text(std::u32string_view text)
+    {
+        /* Glyphs found earlier are marked used this frame, so later ones never evict them. */
+        for (char32_t codepoint : text)
+        {
+            if (!find_glyph(codepoint))
+                return false;
+        }
+        return true;
+    }
+
+    std::vector<AtlasRect> GlyphAtlas::take_dirty_rects()
+    {
+        std::vector<AtlasRect> rects;
+        for (Shelf& shelf : shelves)
+        {
+            if (shelf.dirty_x_max <= shelf.dirty_x_min)
+                continue;
+
+            rects.push_back(AtlasRect{ shelf.dirty_x_min, shelf.y, shelf.dirty_x_max - shelf.dirty_x_min, shelf.height });
+            shelf.dirty_x_min = width;
+            shelf.dirty_x_max = 0;
+        }
+        return rects;
+    }
+
+    const GlyphRegion* GlyphAtlas::add_glyph(uint32_t codepoint, uint16_t& entry)
+    {
+        int index = font.find_character(codepoint);
+        if (index < 0)
+        {
+            entry = MISSING_GLYPH;
+            return nullptr;
+        }
+
+        int glyph_width;
+        int glyph_height;
+        const uint8_t* bits = font.get_font_data(index, glyph_width, glyph_height);
+        int padded_width = glyph_width + 2 * PADDING;
+        int padded_height = glyph_height + 2 * PADDING;
+
+        int shelf_index = find_shelf(padded_width, padded_height);
+        if (shelf_index < 0 || (free_slots.empty() && slots.size() >= MISSING_GLYPH - 1))
+            return nullptr;
+
+        Shelf& shelf = shelves[shelf_index];
+        int x = shelf.x_cursor;
+        shelf.x_cursor += padded_width;
+        shelf.dirty_x_min = std::min(shelf.dirty_x_min, x);
+        shelf.dirty_x_max = std::max(shelf.dirty_x_max, x + padded_width);
+
+        /* Clear the whole cell: an evicted glyph may have left pixels in the padding. */
+        for (int y = 0; y < padded_height; ++y)
+            std::fill_n(pixels.begin() + static_cast<size_t>(shelf.y + y) * width + x, padded_width, uint8_t(0));
+
+        for (int y = 0; y < glyph_height; ++y)
+        {
+            uint8_t* row = pixels.data() + static_cast<size_t>(shelf.y + PADDING + y) * width + x + PADDING;
+            expand_bits_a8(bits, static_cast<size_t>(y) * glyph_width, glyph_width, row, 0xff);
+        }
+
+        uint16_t slot_index;
+        if (free_slots.empty())
+        {
+            slot_index = static_cast<uint16_t>(slots.size());
+            slots.emplace_back();
+        }
+        else
+        {
+            slot_index = free_slots.back();
+            free_slots.pop_back();
+        }
+
+        Slot& slot = slots[slot_index];
+        GlyphRegion& region = slot.region;
+        region.x = static_cast<uint16_t>(x + PADDING);
+        region.y = static_cast<uint16_t>(shelf.y + PADDING);
+        region.width = static_cast<uint8_t>(glyph_width);
+        region.height = static_cast<uint8_t>(glyph_height);
+        region.u0 = static_cast<float>(region.x) / width;
+        region.v0 = static_cast<float>(region.y) / height;
+        region.u1 = static_cast<float>(region.x + glyph_width) / width;
+        region.v1 = static_cast<float>(region.y + glyph_height) / height;
+        slot.codepoint = codepoint;
+        slot.shelf = static_cast<uint16_t>(shelf_index);
+        touch(slot);
+
+        shelf.slots.push_back(slot_index);
+        entry = static_cast<uint16_t>(slot_index + 1);
+        return &region;
+    }
+
+    int GlyphAtlas::find_shelf(int glyph_width, int glyph_height)
+    {
+        if (glyph_width > width || glyph_height > height)
+            return -1;
+
+        /* A shelf of about the glyph's height with room left, the lowest such. */
+        int best = -1;
+        int best_height = INT_MAX;
+        for (int i = 0; i < static_cast<int>(shelves.size()); ++i)
+        {
+            const Shelf& shelf = shelves[i];
+            if (shelf.height >= glyph_height && shelf.height <= glyph_height + glyph_height / 2 &&
+                width - shelf.x_cursor >= glyph_width && shelf.height < best_height)
+            {
+                best = i;
+                best_height = shelf.height;
+            }
+        }
+        if (best >= 0)
+            return best;
+
+        /* A new shelf below the others. */
+        if (height - shelf_bottom >= glyph_height && shelves.size() < UINT16_MAX)
+        {
+            shelves.push_back(Shelf{ shelf_bottom, glyph_height, 0, 0, width, 0, {} });
+            shelf_bottom += glyph_height;
+            return static_cast<int>(shelves.size()) - 1;
+        }
+
+        /* Any taller shelf with room, then the least recently used shelf not needed this frame. */
+        uint32_t oldest_frame = current_frame;
+        for (int i = 0; i < static_cast<int>(shelves.size()); ++i)
+        {
+            const Shelf& shelf = shelves[i];
+            if (shelf.height < glyph_height)
+                continue;
+            if (width - shelf.x_cursor >= glyph_width)
+                return i;
+            if (shelf.last_used_frame < oldest_frame)
+            {
+                best = i;
+                oldest_frame = shelf.last_used_frame;
+            }
+        }
+        if (best >= 0)
+            evict_shelf(shelves[best]);
+        return best;
+    }
+
+    void GlyphAtlas::evict_shelf(Shelf& shelf)
+    {
+        for (uint16_t slot_index : shelf.slots)
+        {
+            get_entry(slots[slot_index].codepoint) = 0;
+            free_slots.push_back(slot_index);
+        }
+        shelf.slots.clear();
+        shelf.x_cursor = 0;
+    }
+
+    void GlyphAtlas::touch(Slot& slot)
+    {
+        slot.last_used_frame = current_frame;
+        shelves[slot.shelf].last_used_frame = current_frame;
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "data/binary_font_data.h"
+
+namespace presenter
+{
+    /* Where a glyph lives in the atlas, in pixels and in texture coordinates. */
+    struct GlyphRegion
+    {
+        uint16_t x;
+        uint16_t y;
+        uint8_t width;
+        uint8_t height;
+        float u0;
+        float v0;
+        float u1;
+        float v1;
+    };
+
+    struct AtlasRect
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    /*
+     * One A8 texture holding the glyphs of a BinaryFontData that are in use, so a string draws
+     * with a single texture bind. Glyphs are unpacked from their 1-bit bitmaps on first use
+     * and packed into shelves: rows of glyphs of similar height, filled left to right.
+     *
+     * Codepoints map to glyphs through a two-level table of 256-entry pages, so a lookup is
+     * two array reads. When the atlas is full, the shelf whose glyphs were used least recently
+     * is emptied and reused. Glyphs used in the current frame, see begin_frame(), are never
+     * evicted.
+     *
+     * The atlas only keeps the pixels; the renderer owns the texture and copies the rectangles
+     * of take_dirty_rects() into it, at most one per shelf.
+     */
+    class GlyphAtlas
+    {
+    public:
+        /* Empty space kept around each glyph so filtering does not pick up its neighbours. */
+        static constexpr int PADDING = 1;
+
+        /* `font` must outlive the atlas. Dimensions are limited to 65535. */
+        GlyphAtlas(const pf::BinaryFontData& font, int width = 512, int height = 512);
+
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+
+        /* Pixels, row major, one byte per pixel. */
+        std::span<const uint8_t> get_pixels() const { return pixels; }
+
+        /* Start a new frame; glyphs used from now on are protected from eviction until the next call. */
+        void begin_frame() { ++current_frame; }
+
+        /*
+         * Region of `codepoint`, unpacking it into the atlas when it is not there. Null when the
+         * font has no such glyph or there is no room even after evicting. The pointer is meant
+         * for the current frame: a glyph left unused for a frame may be evicted and its slot reused.
+         */
+        const GlyphRegion* find_glyph(uint32_t codepoint);
+
+        /*
+         * Make every glyph of `text` resident at the same time, so the whole string can be
+         * drawn with one bind. False when some glyph is missing or they do not all fit.
+         */
+        bool prepare_text(std::u32string_view text);
+
+        /* Areas changed since the last call, to upload. */
+        std::vector<AtlasRect> take_dirty_rects();
+
+    private:
+        static constexpr int PAGE_SIZE = 256;
+        static constexpr int PAGE_COUNT = 0x110000 / PAGE_SIZE;
+        /* Page entries: 0 for unknown, MISSING_GLYPH when the font lacks it, slot index + 1 otherwise. */
+        static constexpr uint16_t MISSING_GLYPH = 0xffff;
+
+        struct Slot
+        {
+            GlyphRegion region;
+            uint32_t codepoint;
+            uint32_t last_used_frame;
+            uint16_t shelf;
+        };
+
+        struct Shelf
+        {
+            int y;
+            int height;
+            int x_cursor;
+            uint32_t last_used_frame;
+            int dirty_x_min;
+            int dirty_x_max;
+            std::vector<uint16_t> slots;
+        };
+
+        uint16_t& get_entry(uint32_t codepoint);
+        const GlyphRegion* add_glyph(uint32_t codepoint, uint16_t& entry);
+        int find_shelf(int glyph_width, int glyph_height);
+        void evict_shelf(Shelf& shelf);
+        void touch(Slot& slot);
+
+        const pf::BinaryFontData& font;
+        int width;
+        int height;
+        std::vector<uint8_t> pixels;
+
+        std::vector<std::unique_ptr<std::array<uint16_t, PAGE_SIZE>>> pages;
+        std::deque<Slot> slots;
+        std::vector<uint16_t> free_slots;
+        std::vector<Shelf> shelves;
+        int shelf_bottom = 0;
+        uint32_t current_frame = 1;
+    };
+}
@@ -1,7 +1,44 @@
+#pragma once
+
+#include "common/math.h"
+#include "presenter/scene_graph.h"
+
 namespace presenter
 {
+    /*
+     * Something on screen, owning a node of a SceneGraph: its transform is relative to the
+     * object it was attached to. Destroying an object removes its node and the nodes below it.
+     */
     class PresentableObject
     {
+    public:
+        PresentableObject(SceneGraph& scene, SceneNode parent = SceneNode(), const pf_math::Rect& bounds = SceneGraph::NO_BOUNDS)
+            : scene(scene), node(scene.create(parent, pf_math::Transform(), bounds))
+        {
+        }
+
+        PresentableObject(const PresentableObject&) = delete;
+        PresentableObject& operator=(const PresentableObject&) = delete;
+
+        virtual ~PresentableObject()
+        {
+            /* The node is gone already when a parent object was destroyed first. */
+            if (scene.contains(node))
+                scene.destroy(node);
+        }
+
+        SceneNode get_node() const { return node; }
+
+        const pf_math::Transform& get_transform() const { return scene.get_local(node); }
+        void set_transform(const pf_math::Transform& transform) { scene.set_local(node, transform); }
+
+        /* Move under `parent`, keeping the local transform. */
+        void attach_to(const PresentableObject& parent) { scene.set_parent(node, parent.node); }
+
+        const pf_math::Mat4& get_world() const { return scene.get_world(node); }
 
+    protected:
+        SceneGraph& scene;
+        SceneNode node;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,161 @@
+#include "render_queue.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace presenter
+{
+    namespace
+    {
+        constexpr int RADIX_BITS = 8;
+        constexpr int RADIX_SIZE = 1 << RADIX_BITS;
+        constexpr int RADIX_PASSES = 64 / RADIX_BITS;
+
+        /* Stable LSD radix sort by key. Passes whose digit is the same in every key are skipped. */
+        template<typename Entry>
+        void radix_sort(std::vector<Entry>& entries, std::vector<Entry>& buffer)
+        {
+            /* All histograms in one read of the keys. */
+            std::vector<uint32_t> counts(RADIX_PASSES * RADIX_SIZE);
+            for (const Entry& entry : entries)
+            {
+                for (int pass = 0; pass < RADIX_PASSES; ++pass)
+                    ++counts[pass * RADIX_SIZE + (entry.sort_key >> (pass * RADIX_BITS) & (RADIX_SIZE - 1))];
+            }
+
+            buffer.resize(entries.size());
+            for (int pass = 0; pass < RADIX_PASSES; ++pass)
+            {
+                uint32_t* count = &counts[pass * RADIX_SIZE];
+                int shift = pass * RADIX_BITS;
+                if (count[entries.front().sort_key >> shift & (RADIX_SIZE - 1)] == entries.size())
+                    continue;
+
+                uint32_t offset = 0;
+                for (int digit = 0; digit < RADIX_SIZE; ++digit)
+                {
+                    uint32_t digit_count = count[digit];
+                    count[digit] = offset;
+                    offset += digit_count;
+                }
+                for (const Entry& entry : entries)
+                    buffer[count[entry.sort_key >> shift & (RADIX_SIZE - 1)]++] = entry;
+                entries.swap(buffer);
+            }
+        }
+
+        uint64_t get_field(uint32_t value, int bits)
+        {
+            return value & ((uint64_t(1) << bits) - 1);
+        }
+    }
+
+    void RenderQueue::Recorder::draw(uint64_t sort_key, const RenderResource& resource, const pf_math::Transform& transform)
+    {
+        packets.push_back(Packet{ sort_key, &resource, transform, MaterialData(), 0, 0 });
+    }
+
+    void RenderQueue::Recorder::draw_sprites(uint64_t sort_key, std::span<const SpriteInstance> new_sprites, const MaterialData& material)
+    {
+        packets.push_back(Packet{ sort_key, nullptr, pf_math::Transform(), material,
+            static_cast<uint32_t>(sprites.size()), static_cast<uint32_t>(new_sprites.size()) });
+        sprites.insert(sprites.end(), new_sprites.begin(), new_sprites.end());
+    }
+
+    uint64_t RenderQueue::make_sort_key(uint8_t layer, bool is_translucent, uint32_t material, uint32_t texture, float depth)
+    {
+        constexpr uint64_t MAX_DEPTH = (uint64_t(1) << DEPTH_BITS) - 1;
+        uint64_t depth_bits = static_cast<uint64_t>(std::clamp(depth, 0.f, 1.f) * MAX_DEPTH);
+
+        uint64_t key = static_cast<uint64_t>(layer) << (64 - LAYER_BITS) | static_cast<uint64_t>(is_translucent) << (63 - LAYER_BITS);
+        if (is_translucent)
+        {
+            return key | (MAX_DEPTH - depth_bits) << (MATERIAL_BITS + TEXTURE_BITS) |
+                get_field(material, MATERIAL_BITS) << TEXTURE_BITS | get_field(texture, TEXTURE_BITS);
+        }
+        return key | get_field(material, MATERIAL_BITS) << (TEXTURE_BITS + DEPTH_BITS) |
+            get_field(texture, TEXTURE_BITS) << DEPTH_BITS | depth_bits;
+    }
+
+    RenderQueue::RenderQueue(unsigned recorder_count)
+    {
+        assert(recorder_count > 0);
+        for (unsigned i = 0; i < recorder_count; ++i)
+            recorders.push_back(std::make_unique<Recorder>());
+    }
+
+    void RenderQueue::submit(Renderer& renderer)
+    {
+        stats = RenderQueueStats();
+        entries.clear();
+        for (uint32_t recorder = 0; recorder < recorders.size(); ++recorder)
+        {
+            const std::vector<Recorder::Packet>& packets = recorders[recorder]->packets;
+            for (uint32_t packet = 0; packet < packets.size(); ++packet)
+                entries.push_back(Entry{ packets[packet].sort_key, recorder, packet });
+        }
+        stats.packet_count = static_cast<uint32_t>(entries.size());
+
+        if (!entries.empty())
+            radix_sort(entries, sort_buffer);
+
+        auto get_packet = [this](const Entry& entry) -> const Recorder::Packet&
+        {
+            return recorders[entry.recorder]->packets[entry.packet];
+        };
+        auto get_sprites = [this](const Entry& entry)
+        {
+            const Recorder& recorder = *recorders[entry.recorder];
+            const Recorder::Packet& packet = recorder.packets[entry.packet];
+            return std::span<const SpriteInstance>(recorder.sprites).subspan(packet.first_sprite, packet.sprite_count);
+        };
+
+        const Recorder::Packet* previous = nullptr;
+        for (size_t i = 0; i < entries.size();)
+        {
+            const Recorder::Packet& packet = get_packet(entries[i]);
+            if (!previous || previous->resource != packet.resource || !(previous->material == packet.material))
+                ++stats.state_changes;
+
+            if (packet.resource)
+            {
+                renderer.render(*packet.resource, packet.transform);
+                previous = &packet;
+                ++stats.draw_calls;
+                ++i;
+                continue;
+            }
+
+            /* Sprite packets of one material in a row are a single draw. */
+            size_t end = i + 1;
+            while (end < entries.size() && !get_packet(entries[end]).resource && get_packet(entries[end]).material == packet.material)
+                ++end;
+
+            if (end == i + 1)
+            {
+                renderer.render_instanced(get_sprites(entries[i]), packet.material);
+            }
+            else
+            {
+                /* A run may span recorders, so its sprites are gathered into one array. */
+                merged_sprites.clear();
+                for (size_t j = i; j < end; ++j)
+                {
+                    std::span<const SpriteInstance> sprites = get_sprites(entries[j]);
+                    merged_sprites.insert(merged_sprites.end(), sprites.begin(), sprites.end());
+                }
+                renderer.render_instanced(merged_sprites, packet.material);
+            }
+
+            previous = &get_packet(entries[end - 1]);
+            ++stats.draw_calls;
+            i = end;
+        }
+
+        for (const std::unique_ptr<Recorder>& recorder : recorders)
+        {
+            recorder->packets.clear();
+            recorder->sprites.clear();
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "common/math.h"
+#include "presenter/renderer/renderer.h"
+
+namespace presenter
+{
+    struct RenderQueueStats
+    {
+        uint32_t packet_count = 0;
+        /* Calls made to the renderer, after merging runs of sprite packets with one material. */
+        uint32_t draw_calls = 0;
+        /* Times the material or resource differed from the previous packet, i.e. binds that were needed. */
+        uint32_t state_changes = 0;
+    };
+
+    /*
+     * Retained command buffer of a frame. Draw packets are recorded with a 64-bit sort key,
+     * see make_sort_key(), and submit() radix sorts them and replays them to a Renderer.
+     *
+     * Sorting groups packets that share a material and texture, so the replay changes state
+     * only when the key says so: consecutive sprite packets of one material become a single
+     * render_instanced() call. The cost of submission is so paid by the game code recording
+     * packets, and the backend only sees sorted, merged draws.
+     *
+     * Packets are recorded into per-thread Recorders without locking, e.g. one per worker of
+     * a ThreadPool, indexed by ThreadPool::get_worker_index(). submit() merges them, keeping
+     * the order of equal keys: recorder by recorder, each in recording order.
+     */
+    class RenderQueue
+    {
+    public:
+        class Recorder
+        {
+        public:
+            /* Draw `resource` with `transform`. The resource must stay alive until submit(). */
+            void draw(uint64_t sort_key, const RenderResource& resource, const pf_math::Transform& transform);
+
+            /* Draw sprites with `material`; the sprites are copied. */
+            void draw_sprites(uint64_t sort_key, std::span<const SpriteInstance> sprites, const MaterialData& material);
+
+            void draw_sprite(uint64_t sort_key, const SpriteInstance& sprite, const MaterialData& material)
+            {
+                draw_sprites(sort_key, std::span<const SpriteInstance>(&sprite, 1), material);
+            }
+
+            size_t get_packet_count() const { return packets.size(); }
+
+        private:
+            friend class RenderQueue;
+
+            struct Packet
+            {
+                uint64_t sort_key;
+                /* Null for sprites. */
+                const RenderResource* resource;
+                pf_math::Transform transform;
+                MaterialData material;
+                uint32_t first_sprite;
+                uint32_t sprite_count;
+            };
+
+            std::vector<Packet> packets;
+            std::vector<SpriteInstance> sprites;
+        };
+
+        static constexpr int LAYER_BITS = 8;
+        static constexpr int MATERIAL_BITS = 16;
+        static constexpr int TEXTURE_BITS = 16;
+        static constexpr int DEPTH_BITS = 23;
+
+        /*
+         * Key ordering packets by layer, then opaque before translucent. Opaque packets then
+         * sort by material, texture and depth front to back, to save binds and overdraw.
+         * Translucent ones sort by depth back to front first, as they must blend in that order,
+         * and by material and texture only between equal depths. `depth` is clamped to [0, 1];
+         * material and texture ids are truncated to 16 bits.
+         */
+        static uint64_t make_sort_key(uint8_t layer, bool is_translucent, uint32_t material, uint32_t texture, float depth);
+
+        /* `recorder_count` recorders, e.g. ThreadPool::get_thread_count() + 1 for every worker and the other threads. */
+        explicit RenderQueue(unsigned recorder_count = 1);
+
+        unsigned get_recorder_count() const { return static_cast<unsigned>(recorders.size()); }
+        Recorder& get_recorder(unsigned index) { return *recorders[index]; }
+
+        /*
+         * Sort the packets of all recorders and draw them with `renderer`, between its
+         * prepare() and present(), then clear the recorders. No recorder may be recording.
+         */
+        void submit(Renderer& renderer);
+
+        /* Statistics of the last submit(). */
+        const RenderQueueStats& get_stats() const { return stats; }
+
+    private:
+        struct Entry
+        {
+            uint64_t sort_key;
+            uint32_t recorder;
+            uint32_t packet;
+        };
+
+        std::vector<std::unique_ptr<Recorder>> recorders;
+
+        /* Reused between submits. */
+        std::vector<Entry> entries;
+        std::vector<Entry> sort_buffer;
+        std::vector<SpriteInstance> merged_sprites;
+        RenderQueueStats stats;
+    };
+}
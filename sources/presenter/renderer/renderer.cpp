@@ -0,0 +1,34 @@
+#include "renderer.h"
+
+#include <algorithm>
+
+namespace presenter
+{
+    void Renderer::render_instanced(std::span<const SpriteInstance> instances, const MaterialData& material)
+    {
+        for (size_t first = 0; first < instances.size(); first += MAX_BATCH_QUADS)
+        {
+            size_t last = std::min(instances.size(), first + MAX_BATCH_QUADS);
+            sprite_vertices.clear();
+            sprite_indices.clear();
+            for (size_t i = first; i < last; ++i)
+            {
+                SpriteInstance sprite = instances[i];
+                pf_math::Vec3 right = sprite.Origin + sprite.AxisX;
+                pf_math::Vec3 bottom = sprite.Origin + sprite.AxisY;
+                pf_math::Vec3 corner = right + sprite.AxisY;
+
+                /* Clockwise from the top left, as front faces are. */
+                uint16_t base = static_cast<uint16_t>(sprite_vertices.size());
+                sprite_vertices.push_back(VertexData{ sprite.Origin, sprite.UVMin });
+                sprite_vertices.push_back(VertexData{ right, pf_math::Vec2(sprite.UVMax.x, sprite.UVMin.y) });
+                sprite_vertices.push_back(VertexData{ bottom, pf_math::Vec2(sprite.UVMin.x, sprite.UVMax.y) });
+                sprite_vertices.push_back(VertexData{ corner, sprite.UVMax });
+                sprite_indices.insert(sprite_indices.end(), { base, static_cast<uint16_t>(base + 1), static_cast<uint16_t>(base + 2),
+                    static_cast<uint16_t>(base + 1), static_cast<uint16_t>(base + 3), static_cast<uint16_t>(base + 2) });
+            }
+
+            render_batch(sprite_vertices, sprite_indices, material);
+        }
+    }
+}
@@ -1,17 +1,94 @@
+#pragma once
+
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include "common/math.h"
 
 namespace presenter
 {
-    class MaterialData {};
-    class RenderResourceData {};
-    class RenderResource {};
+    struct VertexData
+    {
+        pf_math::Vec3 Vertex;
+        pf_math::Vec2 TexCoord;
+    };
+
+    /* RGBA8 pixels, rows top to bottom without padding. Renderers copy what they need. */
+    struct TextureData
+    {
+        const uint8_t* Data;
+        uint32_t Width;
+        uint32_t Height;
+    };
+
+    /* A run of triangles drawn with one texture, or none. */
+    struct FaceInfo
+    {
+        uint32_t IndexOffset;
+        uint32_t IndexCount;
+        bool Textured;
+        uint32_t TextureIndex;
+    };
+
+    /* Triangle list. Without indices, faces index the vertices directly. */
+    struct RenderResourceData
+    {
+        std::vector<VertexData> VertexDataArray;
+        std::vector<uint16_t> IndexArray;
+        std::vector<TextureData> TextureDataArray;
+        std::vector<FaceInfo> FaceInfoArray;
+    };
+
+    enum class BlendMode : uint8_t
+    {
+        Opaque,
+        /* Blended over what is behind by texel alpha, without writing depth. */
+        Alpha,
+    };
+
+    /* How dynamic geometry is drawn, see Renderer::render_batch(). */
+    struct MaterialData
+    {
+        /* From Renderer::create_texture(), or Renderer::NO_TEXTURE for plain white. */
+        uint32_t Texture = 0;
+        BlendMode Blend = BlendMode::Opaque;
+        /* RGBA8 multiplied with the texels, in memory order like TextureData. */
+        uint32_t Tint = 0xffffffff;
+
+        bool operator==(const MaterialData&) const = default;
+    };
+
+    /*
+     * A textured parallelogram: corners Origin, Origin + AxisX, Origin + AxisY and
+     * Origin + AxisX + AxisY, mapped to the texture rectangle from UVMin to UVMax. It faces
+     * the camera when AxisX points right and AxisY down on screen.
+     */
+    struct SpriteInstance
+    {
+        pf_math::Vec3 Origin;
+        pf_math::Vec3 AxisX;
+        pf_math::Vec3 AxisY;
+        pf_math::Vec2 UVMin;
+        pf_math::Vec2 UVMax;
+    };
+
+    /* Renderer specific copy of a RenderResourceData, only usable with the renderer that created it. */
+    class RenderResource
+    {
+    public:
+        virtual ~RenderResource() = default;
+    };
 
     class Renderer
     {
     public:
-        Renderer();
+        static constexpr uint32_t NO_TEXTURE = 0;
+        /* Quads per render_batch() call when sprites are expanded, the most 16-bit indices can address. */
+        static constexpr size_t MAX_BATCH_QUADS = 0x10000 / 4;
+
+        Renderer() = default;
         virtual ~Renderer() {};
 
         /* Prepare for rendering. Should be called each frame before all Render() calling. */
@@ -23,13 +100,36 @@ namespace presenter
         /* Present buffer. Should be called each frame after all Render() calling. */
         virtual void present() = 0;
 
-        /* Create a D3D11 render resource. */
+        /* Create a render resource. */
         virtual std::unique_ptr<RenderResource> create_render_resource(const RenderResourceData& data) = 0;
 
+        /* Create a texture shared by any number of draws, e.g. a sprite sheet or a glyph atlas. Null data clears it. */
+        virtual uint32_t create_texture(const TextureData& data) = 0;
+
+        /* Replace a rectangle of `texture` at (x, y). Textures must not change between their use and present(). */
+        virtual void update_texture(uint32_t texture, uint32_t x, uint32_t y, const TextureData& data) = 0;
+
+        /* Draw a triangle list given in world space with one draw call. The data is consumed before returning. */
+        virtual void render_batch(std::span<const VertexData> vertices, std::span<const uint16_t> indices, const MaterialData& material) = 0;
+
+        /* Whether render_instanced() draws the sprites natively, in one draw call. */
+        virtual bool supports_instancing() const { return false; }
+
+        /*
+         * Draw sprites. Without instancing support, they are expanded into quads and drawn with
+         * render_batch(), one call per MAX_BATCH_QUADS sprites.
+         */
+        virtual void render_instanced(std::span<const SpriteInstance> instances, const MaterialData& material);
+
         /* Set the main camera. */
         // void UseCamera(std::weak_ptr<Camera> camera);
 
         /* Resize buffers. Should be called when resizing the window. */
         virtual void resize_buffers(const pf_math::Rect& client_rect) = 0;
+
+    private:
+        /* Reused by render_instanced() when expanding sprites. */
+        std::vector<VertexData> sprite_vertices;
+        std::vector<uint16_t> sprite_indices;
     };
-}
\ No newline at end of file
+}
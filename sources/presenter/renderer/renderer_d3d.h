@@ -16,40 +16,11 @@ namespace presenter
     template<typename T>
     using ComPtr = Microsoft::WRL::ComPtr<T>;
 
-    struct VertexData
-    {
-        DirectX::XMFLOAT3 Vertex;
-        DirectX::XMFLOAT2 TexCoord;
-    };
-
-    struct TextureData
-    {
-        UINT8* Data;
-        UINT Width;
-        UINT Height;
-    };
-
-    struct FaceInfo
-    {
-        UINT IndexOffset;
-        UINT IndexCount;
-        bool Textured;
-        UINT TextureIndex;
-    };
-
-    struct RenderResourceData
-    {
-        std::vector<VertexData> VertexDataArray;
-        std::vector<UINT16> IndexArray;
-        std::vector<TextureData> TextureDataArray;
-        std::vector<FaceInfo> FaceInfoArray;
-    };
-
     /**
      * Render resource for D3D11. SceneObject takes the ownership of it and should
      * keep it alive as long as rendering is needed.
      */
-    struct D3DRenderResource
+    struct D3DRenderResource : RenderResource
     {
         ComPtr<ID3D11Buffer> VertexBuffer;
         ComPtr<ID3D11Buffer> IndexBuffer;
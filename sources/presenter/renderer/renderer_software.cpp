@@ -0,0 +1,724 @@
+#include "renderer_software.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "common/thread_pool.h"
+
+namespace presenter
+{
+    /* A triangle set up for rasterization, in pixels of the whole target. */
+    struct SoftwareTriangle
+    {
+        /*
+         * Edge functions a * x + b * y + c of the sample position in 1/16 pixels, non-negative
+         * inside. The top-left rule is folded into c.
+         */
+        int64_t edge_a[3];
+        int64_t edge_b[3];
+        int64_t edge_c[3];
+
+        /* Pixels whose centers the bounding box covers, inclusive, clamped to the target. */
+        int min_x;
+        int min_y;
+        int max_x;
+        int max_y;
+
+        /* Planes of depth, 1/w, u/w and v/w: value at the center of pixel (min_x, min_y), and steps. */
+        float attribute[4];
+        float attribute_dx[4];
+        float attribute_dy[4];
+
+        /* Null when untextured. */
+        const SoftwareRenderResource::Texture* texture;
+        /* RGBA8 multiplied with the texels. */
+        uint32_t tint;
+        bool is_blended;
+    };
+
+    namespace
+    {
+        constexpr int SUBPIXEL_BITS = 4;
+        constexpr int SUBPIXEL_SCALE = 1 << SUBPIXEL_BITS;
+        constexpr int HALF_PIXEL = SUBPIXEL_SCALE / 2;
+
+        /* Clip space x and y are kept within this many w, so snapped coordinates fit the edge math. */
+        constexpr float GUARD_BAND = 4.f;
+
+        /* Triangles and vertices per render() task; smaller meshes are set up on the calling thread. */
+        constexpr size_t SETUP_CHUNK_SIZE = 512;
+        constexpr size_t PARALLEL_SETUP_THRESHOLD = 1024;
+
+        constexpr uint32_t WHITE = 0xffffffff;
+
+        /* Near, far, left, right, bottom and top; bit i of an outcode is set outside plane i. */
+        constexpr int CLIP_PLANE_COUNT = 6;
+
+        struct ClipVertex
+        {
+            pf_math::Vec4 position;
+            float u;
+            float v;
+        };
+
+        /* Signed distance of `p` to clip plane `plane`, negative outside. */
+        float get_plane_distance(const pf_math::Vec4& p, int plane)
+        {
+            switch (plane)
+            {
+            case 0: return p.z;
+            case 1: return p.w - p.z;
+            case 2: return p.x + GUARD_BAND * p.w;
+            case 3: return GUARD_BAND * p.w - p.x;
+            case 4: return p.y + GUARD_BAND * p.w;
+            default: return GUARD_BAND * p.w - p.y;
+            }
+        }
+
+        uint8_t get_outcode(const pf_math::Vec4& p)
+        {
+            uint8_t outcode = 0;
+            for (int plane = 0; plane < CLIP_PLANE_COUNT; ++plane)
+            {
+                if (get_plane_distance(p, plane) < 0.f)
+                    outcode |= 1 << plane;
+            }
+            return outcode;
+        }
+
+        /* Sutherland-Hodgman clipping of a convex polygon against the planes in `outcodes`. */
+        int clip_polygon(ClipVertex* polygon, int count, uint8_t outcodes)
+        {
+            ClipVertex buffer[9];
+            ClipVertex* in = polygon;
+            ClipVertex* out = buffer;
+            for (int plane = 0; plane < CLIP_PLANE_COUNT && count >= 3; ++plane)
+            {
+                if (!(outcodes & (1 << plane)))
+                    continue;
+
+                int out_count = 0;
+                for (int i = 0; i < count; ++i)
+                {
+                    const ClipVertex& a = in[i];
+                    const ClipVertex& b = in[(i + 1) % count];
+                    float distance_a = get_plane_distance(a.position, plane);
+                    float distance_b = get_plane_distance(b.position, plane);
+                    if (distance_a >= 0.f)
+                        out[out_count++] = a;
+                    if ((distance_a >= 0.f) != (distance_b >= 0.f))
+                    {
+                        float t = distance_a / (distance_a - distance_b);
+                        ClipVertex& c = out[out_count++];
+                        c.position = pf_math::Vec4(
+                            a.position.x + (b.position.x - a.position.x) * t,
+                            a.position.y + (b.position.y - a.position.y) * t,
+                            a.position.z + (b.position.z - a.position.z) * t,
+                            a.position.w + (b.position.w - a.position.w) * t);
+                        c.u = a.u + (b.u - a.u) * t;
+                        c.v = a.v + (b.v - a.v) * t;
+                    }
+                }
+                std::swap(in, out);
+                count = out_count;
+            }
+
+            if (in != polygon)
+                std::copy(in, in + count, polygon);
+            return count;
+        }
+
+        /* Component-wise a * b of two RGBA8 colors, in [0, 255]. */
+        uint32_t modulate(uint32_t a, uint32_t b)
+        {
+            uint8_t a_bytes[4], b_bytes[4];
+            std::memcpy(a_bytes, &a, 4);
+            std::memcpy(b_bytes, &b, 4);
+            for (int i = 0; i < 4; ++i)
+                a_bytes[i] = static_cast<uint8_t>((a_bytes[i] * b_bytes[i] + 127) / 255);
+            std::memcpy(&a, a_bytes, 4);
+            return a;
+        }
+
+        /* `source` over `destination` by the alpha of `source`. */
+        uint32_t blend(uint32_t source, uint32_t destination)
+        {
+            uint8_t s[4], d[4];
+            std::memcpy(s, &source, 4);
+            std::memcpy(d, &destination, 4);
+            int alpha = s[3];
+            for (int i = 0; i < 3; ++i)
+                d[i] = static_cast<uint8_t>((s[i] * alpha + d[i] * (255 - alpha) + 127) / 255);
+            d[3] = static_cast<uint8_t>(alpha + (d[3] * (255 - alpha) + 127) / 255);
+            std::memcpy(&destination, d, 4);
+            return destination;
+        }
+
+        /* Point sampling with a white border, like the sampler of Renderer_DX11. */
+        uint32_t sample(const SoftwareRenderResource::Texture& texture, float u, float v)
+        {
+            float x = std::floor(u * static_cast<float>(texture.Width));
+            float y = std::floor(v * static_cast<float>(texture.Height));
+            if (!(x >= 0.f && y >= 0.f && x < static_cast<float>(texture.Width) && y < static_cast<float>(texture.Height)))
+                return WHITE;
+            return texture.Pixels[static_cast<size_t>(y) * texture.Width + static_cast<size_t>(x)];
+        }
+
+        /* Color of a covered pixel that passed the depth test, with texture coordinates (u, v). */
+        uint32_t shade(const SoftwareTriangle& triangle, float u, float v, uint32_t destination)
+        {
+            uint32_t color = triangle.texture ? sample(*triangle.texture, u, v) : WHITE;
+            if (triangle.tint != WHITE)
+                color = modulate(color, triangle.tint);
+            return triangle.is_blended ? blend(color, destination) : color;
+        }
+
+        struct ScreenVertex
+        {
+            /* Position in 1/16 pixels. */
+            int64_t x;
+            int64_t y;
+            /* z / w, 1 / w, u / w and v / w, all linear in screen space. */
+            float attribute[4];
+        };
+
+        ScreenVertex to_screen(const ClipVertex& vertex, float half_width, float half_height)
+        {
+            float inverse_w = 1.f / vertex.position.w;
+            ScreenVertex result;
+            result.x = std::llround((vertex.position.x * inverse_w + 1.f) * half_width * SUBPIXEL_SCALE);
+            result.y = std::llround((1.f - vertex.position.y * inverse_w) * half_height * SUBPIXEL_SCALE);
+            result.attribute[0] = vertex.position.z * inverse_w;
+            result.attribute[1] = inverse_w;
+            result.attribute[2] = vertex.u * inverse_w;
+            result.attribute[3] = vertex.v * inverse_w;
+            return result;
+        }
+
+        /* Set up a clipped triangle, false when it is culled or covers no pixel center. */
+        bool setup_triangle(const ScreenVertex* v, int width, int height, SoftwareTriangle& out)
+        {
+            /* Clockwise on screen is the front face, as with the default D3D11 rasterizer state. */
+            int64_t area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+            if (area <= 0)
+                return false;
+
+            int64_t min_x = std::min({ v[0].x, v[1].x, v[2].x });
+            int64_t min_y = std::min({ v[0].y, v[1].y, v[2].y });
+            int64_t max_x = std::max({ v[0].x, v[1].x, v[2].x });
+            int64_t max_y = std::max({ v[0].y, v[1].y, v[2].y });
+            out.min_x = static_cast<int>(std::max<int64_t>((min_x - HALF_PIXEL + SUBPIXEL_SCALE - 1) >> SUBPIXEL_BITS, 0));
+            out.min_y = static_cast<int>(std::max<int64_t>((min_y - HALF_PIXEL + SUBPIXEL_SCALE - 1) >> SUBPIXEL_BITS, 0));
+            out.max_x = static_cast<int>(std::min<int64_t>((max_x - HALF_PIXEL) >> SUBPIXEL_BITS, width - 1));
+            out.max_y = static_cast<int>(std::min<int64_t>((max_y - HALF_PIXEL) >> SUBPIXEL_BITS, height - 1));
+            if (out.min_x > out.max_x || out.min_y > out.max_y)
+                return false;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                const ScreenVertex& a = v[i];
+                const ScreenVertex& b = v[(i + 1) % 3];
+                out.edge_a[i] = a.y - b.y;
+                out.edge_b[i] = b.x - a.x;
+                out.edge_c[i] = a.x * b.y - a.y * b.x;
+                /* Top-left rule: samples exactly on other edges belong to the neighbouring triangle. */
+                bool is_top_left = out.edge_a[i] > 0 || (out.edge_a[i] == 0 && out.edge_b[i] > 0);
+                if (!is_top_left)
+                    out.edge_c[i] -= 1;
+            }
+
+            /* Attribute planes from the snapped positions, so they agree with the coverage. */
+            float x0 = static_cast<float>(v[0].x) / SUBPIXEL_SCALE;
+            float y0 = static_cast<float>(v[0].y) / SUBPIXEL_SCALE;
+            float dx1 = static_cast<float>(v[1].x - v[0].x) / SUBPIXEL_SCALE;
+            float dy1 = static_cast<float>(v[1].y - v[0].y) / SUBPIXEL_SCALE;
+            float dx2 = static_cast<float>(v[2].x - v[0].x) / SUBPIXEL_SCALE;
+            float dy2 = static_cast<float>(v[2].y - v[0].y) / SUBPIXEL_SCALE;
+            float inverse_area = 1.f / (dx1 * dy2 - dx2 * dy1);
+            float origin_x = static_cast<float>(out.min_x) + 0.5f - x0;
+            float origin_y = static_cast<float>(out.min_y) + 0.5f - y0;
+            for (int i = 0; i < 4; ++i)
+            {
+                float d1 = v[1].attribute[i] - v[0].attribute[i];
+                float d2 = v[2].attribute[i] - v[0].attribute[i];
+                out.attribute_dx[i] = (d1 * dy2 - d2 * dy1) * inverse_area;
+                out.attribute_dy[i] = (d2 * dx1 - d1 * dx2) * inverse_area;
+                out.attribute[i] = v[0].attribute[i] + out.attribute_dx[i] * origin_x + out.attribute_dy[i] * origin_y;
+            }
+            return true;
+        }
+    }
+
+    Renderer_Software::Renderer_Software(const pf_math::Rect& client_rect, PresentCallback present_callback, pf::ThreadPool* thread_pool)
+        : present_callback(std::move(present_callback)),
+        thread_pool(thread_pool ? thread_pool : &pf::ThreadPool::get_shared())
+    {
+        set_clear_color(0, 0, 0);
+        resize_buffers(client_rect);
+        apply_size(pending_width, pending_height);
+    }
+
+    Renderer_Software::~Renderer_Software() = default;
+
+    void Renderer_Software::prepare()
+    {
+        if (pending_width != width || pending_height != height)
+            apply_size(pending_width, pending_height);
+
+        triangles.clear();
+        stats = SoftwareRenderStats();
+    }
+
+    void Renderer_Software::render(const RenderResource& renderResource, const pf_math::Transform& transform)
+    {
+        const SoftwareRenderResource& resource = static_cast<const SoftwareRenderResource&>(renderResource);
+
+        std::vector<DrawRun> runs;
+        runs.reserve(resource.FaceInfoArray.size());
+        for (const FaceInfo& face : resource.FaceInfoArray)
+        {
+            const SoftwareRenderResource::Texture* texture = nullptr;
+            if (face.Textured && face.TextureIndex < resource.Textures.size())
+                texture = &resource.Textures[face.TextureIndex];
+            runs.push_back(DrawRun{ face.IndexOffset, face.IndexCount, texture, WHITE, false });
+        }
+
+        /* Like Renderer_DX11, one draw per face. */
+        stats.draw_calls += static_cast<uint32_t>(runs.size());
+        add_triangles(pf_math::Mat4::from_transform(transform) * view_projection, resource.Vertices, resource.Indices, runs);
+    }
+
+    void Renderer_Software::add_triangles(const pf_math::Mat4& model_view_projection, std::span<const VertexData> source_vertices,
+        std::span<const uint16_t> source_indices, std::span<const DrawRun> runs)
+    {
+        /* Triangles of every run, split so large meshes set up in parallel. */
+        struct Chunk
+        {
+            const DrawRun* run;
+            uint32_t first_triangle;
+            uint32_t triangle_count;
+            std::vector<SoftwareTriangle> triangles;
+        };
+        std::vector<Chunk> chunks;
+        size_t triangle_count = 0;
+        for (const DrawRun& run : runs)
+        {
+            uint32_t run_triangles = run.index_count / 3;
+            for (uint32_t first = 0; first < run_triangles; first += SETUP_CHUNK_SIZE)
+                chunks.push_back(Chunk{ &run, first, std::min<uint32_t>(SETUP_CHUNK_SIZE, run_triangles - first), {} });
+            triangle_count += run_triangles;
+        }
+        stats.submitted_triangles += static_cast<uint32_t>(triangle_count);
+
+        std::vector<ClipVertex> vertices(source_vertices.size());
+        std::vector<uint8_t> outcodes(source_vertices.size());
+        auto transform_vertices = [&](size_t chunk)
+        {
+            size_t end = std::min(vertices.size(), (chunk + 1) * SETUP_CHUNK_SIZE);
+            for (size_t i = chunk * SETUP_CHUNK_SIZE; i < end; ++i)
+            {
+                const VertexData& vertex = source_vertices[i];
+                vertices[i].position = model_view_projection.transform(pf_math::Vec4(vertex.Vertex, 1.f));
+                vertices[i].u = vertex.TexCoord.x;
+                vertices[i].v = vertex.TexCoord.y;
+                outcodes[i] = get_outcode(vertices[i].position);
+            }
+        };
+
+        float half_width = static_cast<float>(width) * 0.5f;
+        float half_height = static_cast<float>(height) * 0.5f;
+        auto setup_chunk = [&](size_t chunk_index)
+        {
+            Chunk& chunk = chunks[chunk_index];
+            const DrawRun& run = *chunk.run;
+
+            for (uint32_t t = chunk.first_triangle; t < chunk.first_triangle + chunk.triangle_count; ++t)
+            {
+                size_t indices[3];
+                for (int i = 0; i < 3; ++i)
+                {
+                    size_t index = run.first_index + t * 3 + i;
+                    indices[i] = source_indices.empty() ? index : source_indices[index];
+                    assert(indices[i] < vertices.size());
+                }
+
+                uint8_t outcode_and = outcodes[indices[0]] & outcodes[indices[1]] & outcodes[indices[2]];
+                uint8_t outcode_or = outcodes[indices[0]] | outcodes[indices[1]] | outcodes[indices[2]];
+                if (outcode_and)
+                    continue;
+
+                ClipVertex polygon[9] = { vertices[indices[0]], vertices[indices[1]], vertices[indices[2]] };
+                int count = outcode_or ? clip_polygon(polygon, 3, outcode_or) : 3;
+                if (count < 3)
+                    continue;
+
+                ScreenVertex screen[9];
+                for (int i = 0; i < count; ++i)
+                    screen[i] = to_screen(polygon[i], half_width, half_height);
+
+                for (int i = 1; i + 1 < count; ++i)
+                {
+                    ScreenVertex fan[3] = { screen[0], screen[i], screen[i + 1] };
+                    SoftwareTriangle triangle;
+                    if (setup_triangle(fan, width, height, triangle))
+                    {
+                        triangle.texture = run.texture;
+                        triangle.tint = run.tint;
+                        triangle.is_blended = run.is_blended;
+                        chunk.triangles.push_back(triangle);
+                    }
+                }
+            }
+        };
+
+        size_t vertex_chunk_count = (vertices.size() + SETUP_CHUNK_SIZE - 1) / SETUP_CHUNK_SIZE;
+        if (triangle_count >= PARALLEL_SETUP_THRESHOLD)
+        {
+            thread_pool->parallel_for(vertex_chunk_count, transform_vertices);
+            thread_pool->parallel_for(chunks.size(), setup_chunk);
+        }
+        else
+        {
+            for (size_t i = 0; i < vertex_chunk_count; ++i)
+                transform_vertices(i);
+            for (size_t i = 0; i < chunks.size(); ++i)
+                setup_chunk(i);
+        }
+
+        /* Submission order is kept, so equal depths and blending resolve as on the GPU. */
+        for (const Chunk& chunk : chunks)
+            triangles.insert(triangles.end(), chunk.triangles.begin(), chunk.triangles.end());
+    }
+
+    void Renderer_Software::present()
+    {
+        for (std::vector<uint32_t>& bin : tile_bins)
+            bin.clear();
+
+        for (size_t i = 0; i < triangles.size(); ++i)
+        {
+            const SoftwareTriangle& triangle = triangles[i];
+            for (int tile_y = triangle.min_y / TILE_SIZE; tile_y <= triangle.max_y / TILE_SIZE; ++tile_y)
+            {
+                for (int tile_x = triangle.min_x / TILE_SIZE; tile_x <= triangle.max_x / TILE_SIZE; ++tile_x)
+                    tile_bins[tile_y * tile_columns + tile_x].push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        stats.rasterized_triangles = static_cast<uint32_t>(triangles.size());
+        stats.binned_triangles = 0;
+        for (const std::vector<uint32_t>& bin : tile_bins)
+            stats.binned_triangles += static_cast<uint32_t>(bin.size());
+
+        thread_pool->parallel_for(tile_bins.size(), [this](size_t tile_index) { rasterize_tile(static_cast<int>(tile_index)); });
+
+        if (present_callback)
+            present_callback(color_buffer.data(), width, height, stride * static_cast<int>(sizeof(uint32_t)));
+    }
+
+    std::unique_ptr<RenderResource> Renderer_Software::create_render_resource(const RenderResourceData& data)
+    {
+        assert(!data.VertexDataArray.empty());
+
+        std::unique_ptr<SoftwareRenderResource> resource = std::make_unique<SoftwareRenderResource>();
+        resource->Vertices = data.VertexDataArray;
+        resource->Indices = data.IndexArray;
+        resource->FaceInfoArray = data.FaceInfoArray;
+
+        for (const TextureData& texture_data : data.TextureDataArray)
+            resource->Textures.push_back(make_texture(texture_data));
+
+        return resource;
+    }
+
+    uint32_t Renderer_Software::create_texture(const TextureData& data)
+    {
+        textures.push_back(make_texture(data));
+        return static_cast<uint32_t>(textures.size());
+    }
+
+    void Renderer_Software::update_texture(uint32_t texture, uint32_t x, uint32_t y, const TextureData& data)
+    {
+        assert(texture != NO_TEXTURE && texture <= textures.size());
+        SoftwareRenderResource::Texture& target = textures[texture - 1];
+        assert(x + data.Width <= static_cast<uint32_t>(target.Width) && y + data.Height <= static_cast<uint32_t>(target.Height));
+
+        for (uint32_t row = 0; row < data.Height; ++row)
+        {
+            std::memcpy(&target.Pixels[static_cast<size_t>(y + row) * target.Width + x],
+                data.Data + static_cast<size_t>(row) * data.Width * 4, static_cast<size_t>(data.Width) * 4);
+        }
+    }
+
+    void Renderer_Software::render_batch(std::span<const VertexData> vertices, std::span<const uint16_t> indices, const MaterialData& material)
+    {
+        uint32_t index_count = static_cast<uint32_t>(indices.empty() ? vertices.size() : indices.size());
+        DrawRun run = { 0, index_count, find_texture(material.Texture), material.Tint, material.Blend == BlendMode::Alpha };
+        ++stats.draw_calls;
+        add_triangles(view_projection, vertices, indices, std::span<const DrawRun>(&run, 1));
+    }
+
+    void Renderer_Software::render_instanced(std::span<const SpriteInstance> instances, const MaterialData& material)
+    {
+        /* The instance expansion a vertex shader would do, straight into the setup input. */
+        std::vector<VertexData> vertices;
+        vertices.reserve(instances.size() * 6);
+        for (const SpriteInstance& sprite : instances)
+        {
+            pf_math::Vec3 origin = sprite.Origin;
+            pf_math::Vec3 right = origin + sprite.AxisX;
+            pf_math::Vec3 bottom = origin + sprite.AxisY;
+            pf_math::Vec3 corner = right + sprite.AxisY;
+            VertexData top_left = { origin, sprite.UVMin };
+            VertexData top_right = { right, pf_math::Vec2(sprite.UVMax.x, sprite.UVMin.y) };
+            VertexData bottom_left = { bottom, pf_math::Vec2(sprite.UVMin.x, sprite.UVMax.y) };
+            VertexData bottom_right = { corner, sprite.UVMax };
+            vertices.insert(vertices.end(), { top_left, top_right, bottom_left, top_right, bottom_right, bottom_left });
+        }
+
+        DrawRun run = { 0, static_cast<uint32_t>(vertices.size()), find_texture(material.Texture), material.Tint, material.Blend == BlendMode::Alpha };
+        ++stats.draw_calls;
+        add_triangles(view_projection, vertices, {}, std::span<const DrawRun>(&run, 1));
+    }
+
+    void Renderer_Software::resize_buffers(const pf_math::Rect& client_rect)
+    {
+        pending_width = std::max(1, static_cast<int>(client_rect.x_max - client_rect.x_min));
+        pending_height = std::max(1, static_cast<int>(client_rect.y_max - client_rect.y_min));
+        assert(pending_width <= MAX_SIZE && pending_height <= MAX_SIZE);
+    }
+
+    SoftwareRenderResource::Texture Renderer_Software::make_texture(const TextureData& data)
+    {
+        SoftwareRenderResource::Texture texture;
+        texture.Width = static_cast<int>(data.Width);
+        texture.Height = static_cast<int>(data.Height);
+        texture.Pixels.resize(static_cast<size_t>(data.Width) * data.Height);
+        if (data.Data)
+            std::memcpy(texture.Pixels.data(), data.Data, texture.Pixels.size() * sizeof(uint32_t));
+        return texture;
+    }
+
+    const SoftwareRenderResource::Texture* Renderer_Software::find_texture(uint32_t texture) const
+    {
+        assert(texture <= textures.size());
+        return texture == NO_TEXTURE ? nullptr : &textures[texture - 1];
+    }
+
+    void Renderer_Software::set_view_projection(const pf_math::Mat4& new_view_projection)
+    {
+        view_projection = new_view_projection;
+        has_custom_view_projection = true;
+    }
+
+    void Renderer_Software::set_clear_color(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+    {
+        uint8_t bytes[4] = { r, g, b, a };
+        std::memcpy(&clear_color, bytes, sizeof(clear_color));
+    }
+
+    void Renderer_Software::apply_size(int new_width, int new_height)
+    {
+        width = new_width;
+        height = new_height;
+        tile_columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+        tile_rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+        stride = tile_columns * TILE_SIZE;
+
+        size_t pixel_count = static_cast<size_t>(stride) * tile_rows * TILE_SIZE;
+        color_buffer.assign(pixel_count, clear_color);
+        depth_buffer.assign(pixel_count, 1.f);
+        tile_bins.resize(static_cast<size_t>(tile_columns) * tile_rows);
+
+        if (!has_custom_view_projection)
+        {
+            /* The default camera of Renderer_DX11: at the origin, looking down +z. */
+            view_projection = pf_math::Mat4::perspective_fov_lh(std::numbers::pi_v<float> / 4.f,
+                static_cast<float>(width) / static_cast<float>(height), 0.1f, 10000.f);
+        }
+    }
+
+    void Renderer_Software::rasterize_tile(int tile_index)
+    {
+        int tile_x = tile_index % tile_columns * TILE_SIZE;
+        int tile_y = tile_index / tile_columns * TILE_SIZE;
+
+        for (int y = tile_y; y < tile_y + TILE_SIZE; ++y)
+        {
+            std::fill_n(&color_buffer[static_cast<size_t>(y) * stride + tile_x], TILE_SIZE, clear_color);
+            std::fill_n(&depth_buffer[static_cast<size_t>(y) * stride + tile_x], TILE_SIZE, 1.f);
+        }
+
+        for (uint32_t triangle_index : tile_bins[tile_index])
+        {
+            const SoftwareTriangle& triangle = triangles[triangle_index];
+            int min_x = std::max(triangle.min_x, tile_x);
+            int min_y = std::max(triangle.min_y, tile_y);
+            int max_x = std::min(triangle.max_x, tile_x + TILE_SIZE - 1);
+            int max_y = std::min(triangle.max_y, tile_y + TILE_SIZE - 1);
+
+            /*
+             * Classify the edges over the rectangle: one outside rejects the triangle, one
+             * inside drops out of the per-pixel test. The rest cross the tile, so their values
+             * in it stay below 2^31 and step in 32 bits.
+             */
+            int32_t edge_row[3] = {};
+            int32_t edge_dx[3] = {};
+            int32_t edge_dy[3] = {};
+            bool is_rejected = false;
+            int64_t sample_x = static_cast<int64_t>(min_x) * SUBPIXEL_SCALE + HALF_PIXEL;
+            int64_t sample_y = static_cast<int64_t>(min_y) * SUBPIXEL_SCALE + HALF_PIXEL;
+            int64_t span_x = static_cast<int64_t>(max_x - min_x) * SUBPIXEL_SCALE;
+            int64_t span_y = static_cast<int64_t>(max_y - min_y) * SUBPIXEL_SCALE;
+            for (int i = 0; i < 3; ++i)
+            {
+                int64_t a = triangle.edge_a[i];
+                int64_t b = triangle.edge_b[i];
+                int64_t corner = a * sample_x + b * sample_y + triangle.edge_c[i];
+                int64_t low = corner + std::min<int64_t>(a * span_x, 0) + std::min<int64_t>(b * span_y, 0);
+                int64_t high = corner + std::max<int64_t>(a * span_x, 0) + std::max<int64_t>(b * span_y, 0);
+                if (high < 0)
+                {
+                    is_rejected = true;
+                    break;
+                }
+                if (low < 0)
+                {
+                    edge_row[i] = static_cast<int32_t>(corner);
+                    edge_dx[i] = static_cast<int32_t>(a * SUBPIXEL_SCALE);
+                    edge_dy[i] = static_cast<int32_t>(b * SUBPIXEL_SCALE);
+                }
+            }
+            if (is_rejected)
+                continue;
+
+            float offset_x = static_cast<float>(min_x - triangle.min_x);
+            float offset_y = static_cast<float>(min_y - triangle.min_y);
+            float attribute_row[4];
+            for (int i = 0; i < 4; ++i)
+                attribute_row[i] = triangle.attribute[i] + triangle.attribute_dx[i] * offset_x + triangle.attribute_dy[i] * offset_y;
+
+#if defined(__SSE2__) || defined(_M_X64)
+            bool is_shaded = triangle.texture || triangle.tint != WHITE || triangle.is_blended;
+
+            /* Groups of four pixels from a 16 byte boundary; lanes outside [min_x, max_x] are masked. */
+            int group_x = min_x & ~3;
+            float group_offset = static_cast<float>(group_x - min_x);
+            const __m128i lane_index = _mm_set_epi32(3, 2, 1, 0);
+            const __m128 lane_offset = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+            __m128i edge_step[3];
+            __m128 attribute_step[4];
+            for (int i = 0; i < 3; ++i)
+                edge_step[i] = _mm_set1_epi32(edge_dx[i] * 4);
+            for (int i = 0; i < 4; ++i)
+                attribute_step[i] = _mm_set1_ps(triangle.attribute_dx[i] * 4.f);
+
+            for (int y = min_y; y <= max_y; ++y)
+            {
+                __m128i edge[3];
+                __m128 attribute[4];
+                for (int i = 0; i < 3; ++i)
+                {
+                    __m128i lane_dx = _mm_set_epi32(edge_dx[i] * 3, edge_dx[i] * 2, edge_dx[i], 0);
+                    edge[i] = _mm_add_epi32(_mm_set1_epi32(edge_row[i] + edge_dx[i] * (group_x - min_x)), lane_dx);
+                }
+                for (int i = 0; i < 4; ++i)
+                {
+                    __m128 lane_dx = _mm_mul_ps(_mm_add_ps(lane_offset, _mm_set1_ps(group_offset)), _mm_set1_ps(triangle.attribute_dx[i]));
+                    attribute[i] = _mm_add_ps(_mm_set1_ps(attribute_row[i]), lane_dx);
+                }
+
+                uint32_t* color_row = &color_buffer[static_cast<size_t>(y) * stride];
+                float* depth_row = &depth_buffer[static_cast<size_t>(y) * stride];
+                for (int x = group_x; x <= max_x; x += 4)
+                {
+                    __m128i lane_x = _mm_add_epi32(_mm_set1_epi32(x), lane_index);
+                    __m128i in_range = _mm_andnot_si128(
+                        _mm_or_si128(_mm_cmplt_epi32(lane_x, _mm_set1_epi32(min_x)), _mm_cmpgt_epi32(lane_x, _mm_set1_epi32(max_x))),
+                        _mm_set1_epi32(-1));
+                    __m128i outside = _mm_srai_epi32(_mm_or_si128(_mm_or_si128(edge[0], edge[1]), edge[2]), 31);
+                    __m128i mask = _mm_andnot_si128(outside, in_range);
+
+                    __m128 depth = _mm_loadu_ps(depth_row + x);
+                    mask = _mm_and_si128(mask, _mm_castps_si128(_mm_cmplt_ps(attribute[0], depth)));
+                    int lanes = _mm_movemask_ps(_mm_castsi128_ps(mask));
+                    if (lanes)
+                    {
+                        __m128i old_color = _mm_loadu_si128(reinterpret_cast<const __m128i*>(color_row + x));
+                        __m128i color = _mm_set1_epi32(static_cast<int>(WHITE));
+                        if (is_shaded)
+                        {
+                            /* No gather in SSE2: texels are fetched per lane. */
+                            __m128 w = _mm_div_ps(_mm_set1_ps(1.f), attribute[1]);
+                            alignas(16) float u[4];
+                            alignas(16) float v[4];
+                            alignas(16) uint32_t colors[4];
+                            _mm_store_ps(u, _mm_mul_ps(attribute[2], w));
+                            _mm_store_ps(v, _mm_mul_ps(attribute[3], w));
+                            _mm_store_si128(reinterpret_cast<__m128i*>(colors), old_color);
+                            for (int lane = 0; lane < 4; ++lane)
+                            {
+                                if (lanes & (1 << lane))
+                                    colors[lane] = shade(triangle, u[lane], v[lane], colors[lane]);
+                            }
+                            color = _mm_load_si128(reinterpret_cast<const __m128i*>(colors));
+                        }
+
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(color_row + x),
+                            _mm_or_si128(_mm_and_si128(mask, color), _mm_andnot_si128(mask, old_color)));
+                        if (!triangle.is_blended)
+                        {
+                            __m128 depth_mask = _mm_castsi128_ps(mask);
+                            _mm_storeu_ps(depth_row + x, _mm_or_ps(_mm_and_ps(depth_mask, attribute[0]), _mm_andnot_ps(depth_mask, depth)));
+                        }
+                    }
+
+                    for (int i = 0; i < 3; ++i)
+                        edge[i] = _mm_add_epi32(edge[i], edge_step[i]);
+                    for (int i = 0; i < 4; ++i)
+                        attribute[i] = _mm_add_ps(attribute[i], attribute_step[i]);
+                }
+
+                for (int i = 0; i < 3; ++i)
+                    edge_row[i] += edge_dy[i];
+                for (int i = 0; i < 4; ++i)
+                    attribute_row[i] += triangle.attribute_dy[i];
+            }
+#else
+            for (int y = min_y; y <= max_y; ++y)
+            {
+                int32_t edge[3] = { edge_row[0], edge_row[1], edge_row[2] };
+                float attribute[4] = { attribute_row[0], attribute_row[1], attribute_row[2], attribute_row[3] };
+                uint32_t* color_row = &color_buffer[static_cast<size_t>(y) * stride];
+                float* depth_row = &depth_buffer[static_cast<size_t>(y) * stride];
+                for (int x = min_x; x <= max_x; ++x)
+                {
+                    if ((edge[0] | edge[1] | edge[2]) >= 0 && attribute[0] < depth_row[x])
+                    {
+                        color_row[x] = shade(triangle, attribute[2] / attribute[1], attribute[3] / attribute[1], color_row[x]);
+                        if (!triangle.is_blended)
+                            depth_row[x] = attribute[0];
+                    }
+
+                    for (int i = 0; i < 3; ++i)
+                        edge[i] += edge_dx[i];
+                    for (int i = 0; i < 4; ++i)
+                        attribute[i] += triangle.attribute_dx[i];
+                }
+
+                for (int i = 0; i < 3; ++i)
+                    edge_row[i] += edge_dy[i];
+                for (int i = 0; i < 4; ++i)
+                    attribute_row[i] += triangle.attribute_dy[i];
+            }
+#endif
+        }
+    }
+}
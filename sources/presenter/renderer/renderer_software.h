@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "common/math.h"
+#include "presenter/renderer/renderer.h"
+
+namespace pf
+{
+    class ThreadPool;
+}
+
+namespace presenter
+{
+    struct SoftwareTriangle;
+
+    /* Render resource of Renderer_Software: the resource data, copied, textures as packed RGBA8. */
+    struct SoftwareRenderResource : RenderResource
+    {
+        struct Texture
+        {
+            std::vector<uint32_t> Pixels;
+            int Width;
+            int Height;
+        };
+
+        std::vector<VertexData> Vertices;
+        std::vector<uint16_t> Indices;
+        std::vector<Texture> Textures;
+        std::vector<FaceInfo> FaceInfoArray;
+    };
+
+    struct SoftwareRenderStats
+    {
+        /* Triangles submitted in the frame, and those left after culling and clipping. */
+        uint32_t submitted_triangles = 0;
+        uint32_t rasterized_triangles = 0;
+        /* Tile and triangle pairs rasterized. */
+        uint32_t binned_triangles = 0;
+        /* Faces of render(), plus batches and instanced draws. */
+        uint32_t draw_calls = 0;
+    };
+
+    /*
+     * CPU renderer with the pipeline of Renderer_DX11: position and texture coordinate
+     * vertices, back faces culled, a depth test and point sampled textures with a white
+     * border. It needs no GPU, so the real render path runs on any machine. Batches may also
+     * be tinted and alpha blended; blended triangles test depth without writing it.
+     *
+     * render() transforms and clips the triangles and sets up their edge and attribute
+     * equations, in parallel for large meshes. present() sorts them into 64x64 pixel tiles and
+     * rasterizes the tiles in parallel, each tile clearing its own pixels first. Inside a tile,
+     * coverage, depth and attributes are evaluated four pixels at a time with SSE2. Vertices
+     * snap to 1/16 pixel and edges follow the top-left rule, so triangles sharing an edge
+     * never overlap or leave gaps.
+     *
+     * The frame is RGBA8, SDL_PIXELFORMAT_RGBA32, and is handed to the present callback, e.g.
+     * to update an SDL texture, or read back with get_color_buffer().
+     */
+    class Renderer_Software : public Renderer
+    {
+    public:
+        /* Receives the finished frame; `pitch` is in bytes. */
+        using PresentCallback = std::function<void(const uint32_t* pixels, int width, int height, int pitch)>;
+
+        static constexpr int TILE_SIZE = 64;
+        /* Largest width or height, which keeps edge equations within 32 bits inside a tile. */
+        static constexpr int MAX_SIZE = 8192;
+
+        /* Render to a buffer of the size of `client_rect` on `thread_pool`, the shared pool when null. */
+        explicit Renderer_Software(const pf_math::Rect& client_rect, PresentCallback present_callback = nullptr,
+            pf::ThreadPool* thread_pool = nullptr);
+        ~Renderer_Software();
+
+        void prepare() override;
+        void render(const RenderResource& renderResource, const pf_math::Transform& transform) override;
+        void present() override;
+        std::unique_ptr<RenderResource> create_render_resource(const RenderResourceData& data) override;
+        void resize_buffers(const pf_math::Rect& client_rect) override;
+
+        uint32_t create_texture(const TextureData& data) override;
+        void update_texture(uint32_t texture, uint32_t x, uint32_t y, const TextureData& data) override;
+        void render_batch(std::span<const VertexData> vertices, std::span<const uint16_t> indices, const MaterialData& material) override;
+        bool supports_instancing() const override { return true; }
+        void render_instanced(std::span<const SpriteInstance> instances, const MaterialData& material) override;
+
+        /* Replace the default camera, which looks down +z from the origin with a 45 degree field of view. */
+        void set_view_projection(const pf_math::Mat4& view_projection);
+        void set_clear_color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
+
+        int get_width() const { return width; }
+        int get_height() const { return height; }
+        /* Pixels per row of the buffers, a multiple of TILE_SIZE. */
+        int get_stride() const { return stride; }
+
+        /* The last presented frame, get_stride() pixels per row. */
+        std::span<const uint32_t> get_color_buffer() const { return color_buffer; }
+        std::span<const float> get_depth_buffer() const { return depth_buffer; }
+
+        const SoftwareRenderStats& get_stats() const { return stats; }
+
+    private:
+        /* A range of indices drawn with one texture and blend state. */
+        struct DrawRun
+        {
+            uint32_t first_index;
+            uint32_t index_count;
+            const SoftwareRenderResource::Texture* texture;
+            uint32_t tint;
+            bool is_blended;
+        };
+
+        void add_triangles(const pf_math::Mat4& model_view_projection, std::span<const VertexData> vertices,
+            std::span<const uint16_t> indices, std::span<const DrawRun> runs);
+        static SoftwareRenderResource::Texture make_texture(const TextureData& data);
+        const SoftwareRenderResource::Texture* find_texture(uint32_t texture) const;
+        void apply_size(int new_width, int new_height);
+        void rasterize_tile(int tile_index);
+
+        int width = 0;
+        int height = 0;
+        int stride = 0;
+        int tile_columns = 0;
+        int tile_rows = 0;
+        int pending_width = 0;
+        int pending_height = 0;
+
+        std::vector<uint32_t> color_buffer;
+        std::vector<float> depth_buffer;
+        uint32_t clear_color = 0;
+
+        pf_math::Mat4 view_projection;
+        bool has_custom_view_projection = false;
+
+        /* Textures of create_texture(), by handle - 1. A deque, so triangles can point into it. */
+        std::deque<SoftwareRenderResource::Texture> textures;
+
+        std::vector<SoftwareTriangle> triangles;
+        std::vector<std::vector<uint32_t>> tile_bins;
+
+        PresentCallback present_callback;
+        pf::ThreadPool* thread_pool;
+        SoftwareRenderStats stats;
+    };
+}
@@ -0,0 +1,313 @@
+#include "scene_graph.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace presenter
+{
+    namespace
+    {
+        bool overlaps(const pf_math::Rect& a, const pf_math::Rect& b)
+        {
+            return a.x_min <= b.x_max && b.x_min <= a.x_max && a.y_min <= b.y_max && b.y_min <= a.y_max;
+        }
+
+        pf_math::Rect unite(const pf_math::Rect& a, const pf_math::Rect& b)
+        {
+            return pf_math::Rect{ std::min(a.x_min, b.x_min), std::min(a.y_min, b.y_min),
+                std::max(a.x_max, b.x_max), std::max(a.y_max, b.y_max) };
+        }
+
+        /* Bounding rectangle of the x-y projection of `bounds`, taken at z = 0 and transformed by `world`. */
+        pf_math::Rect transform_bounds(const pf_math::Mat4& world, const pf_math::Rect& bounds)
+        {
+            if (bounds.x_min > bounds.x_max || bounds.y_min > bounds.y_max)
+                return SceneGraph::NO_BOUNDS;
+
+            pf_math::Rect result = SceneGraph::NO_BOUNDS;
+            for (float x : { bounds.x_min, bounds.x_max })
+            {
+                for (float y : { bounds.y_min, bounds.y_max })
+                {
+                    float world_x = x * world.m[0][0] + y * world.m[1][0] + world.m[3][0];
+                    float world_y = x * world.m[0][1] + y * world.m[1][1] + world.m[3][1];
+                    result = unite(result, pf_math::Rect{ world_x, world_y, world_x, world_y });
+                }
+            }
+            return result;
+        }
+    }
+
+    SceneNode SceneGraph::create(SceneNode parent, const pf_math::Transform& local, const pf_math::Rect& node_bounds)
+    {
+        uint32_t parent_index = parent.slot == UINT32_MAX ? NO_PARENT : get_index(parent);
+        uint32_t index = parent_index == NO_PARENT ? static_cast<uint32_t>(slots.size()) : parent_index + subtree_sizes[parent_index];
+
+        uint32_t slot;
+        if (free_slots.empty())
+        {
+            slot = static_cast<uint32_t>(slot_indices.size());
+            slot_indices.push_back(index);
+            slot_generations.push_back(0);
+        }
+        else
+        {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+
+        /* The last child goes at the end of its parent's subtree, moving the nodes after it. */
+        slots.insert(slots.begin() + index, slot);
+        parents.insert(parents.begin() + index, parent_index);
+        subtree_sizes.insert(subtree_sizes.begin() + index, 1);
+        flags.insert(flags.begin() + index, 0);
+        locals.insert(locals.begin() + index, local);
+        worlds.insert(worlds.begin() + index, pf_math::Mat4());
+        bounds.insert(bounds.begin() + index, node_bounds);
+        world_bounds.insert(world_bounds.begin() + index, NO_BOUNDS);
+        subtree_bounds.insert(subtree_bounds.begin() + index, NO_BOUNDS);
+
+        for (uint32_t i = index; i < slots.size(); ++i)
+        {
+            if (i > index && parents[i] != NO_PARENT && parents[i] >= index)
+                ++parents[i];
+            slot_indices[slots[i]] = i;
+        }
+        for (uint32_t ancestor = parent_index; ancestor != NO_PARENT; ancestor = parents[ancestor])
+            ++subtree_sizes[ancestor];
+
+        mark_dirty(index);
+        return SceneNode{ slot, slot_generations[slot] };
+    }
+
+    void SceneGraph::destroy(SceneNode node)
+    {
+        uint32_t index = get_index(node);
+        uint32_t count = subtree_sizes[index];
+        uint32_t end = index + count;
+
+        for (uint32_t i = index; i < end; ++i)
+        {
+            ++slot_generations[slots[i]];
+            free_slots.push_back(slots[i]);
+        }
+
+        /* The ancestors' subtree bounds shrink. */
+        uint32_t parent = parents[index];
+        for (uint32_t ancestor = parent; ancestor != NO_PARENT; ancestor = parents[ancestor])
+            subtree_sizes[ancestor] -= count;
+        if (parent != NO_PARENT)
+            mark_has_dirty(parent);
+
+        slots.erase(slots.begin() + index, slots.begin() + end);
+        parents.erase(parents.begin() + index, parents.begin() + end);
+        subtree_sizes.erase(subtree_sizes.begin() + index, subtree_sizes.begin() + end);
+        flags.erase(flags.begin() + index, flags.begin() + end);
+        locals.erase(locals.begin() + index, locals.begin() + end);
+        worlds.erase(worlds.begin() + index, worlds.begin() + end);
+        bounds.erase(bounds.begin() + index, bounds.begin() + end);
+        world_bounds.erase(world_bounds.begin() + index, world_bounds.begin() + end);
+        subtree_bounds.erase(subtree_bounds.begin() + index, subtree_bounds.begin() + end);
+
+        for (uint32_t i = index; i < slots.size(); ++i)
+        {
+            if (parents[i] != NO_PARENT && parents[i] >= end)
+                parents[i] -= count;
+            slot_indices[slots[i]] = i;
+        }
+    }
+
+    bool SceneGraph::contains(SceneNode node) const
+    {
+        return node.slot < slot_generations.size() && slot_generations[node.slot] == node.generation;
+    }
+
+    void SceneGraph::set_parent(SceneNode node, SceneNode parent)
+    {
+        uint32_t index = get_index(node);
+        uint32_t parent_index = parent.slot == UINT32_MAX ? NO_PARENT : get_index(parent);
+        assert(parent_index == NO_PARENT || parent_index < index || parent_index >= index + subtree_sizes[index]);
+
+        if (parents[index] != NO_PARENT)
+            mark_has_dirty(parents[index]);
+        parents[index] = parent_index;
+
+        /*
+         * Rebuild the depth-first order: children are grouped by parent, in their current
+         * order, with the moved node last. Then the arrays are permuted to the new order.
+         */
+        uint32_t count = static_cast<uint32_t>(slots.size());
+        auto get_group = [this](uint32_t i) { return parents[i] == NO_PARENT ? static_cast<uint32_t>(slots.size()) : parents[i]; };
+
+        std::vector<uint32_t> group_starts(count + 3, 0);
+        for (uint32_t i = 0; i < count; ++i)
+            ++group_starts[get_group(i) + 2];
+        for (uint32_t group = 0; group <= count; ++group)
+            group_starts[group + 2] += group_starts[group + 1];
+
+        std::vector<uint32_t> children(count);
+        auto add_child = [&](uint32_t i) { children[group_starts[get_group(i) + 1]++] = i; };
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (i != index)
+                add_child(i);
+        }
+        add_child(index);
+
+        /* order[new index] = old index, by an explicit stack walk from the roots. */
+        std::vector<uint32_t> order;
+        order.reserve(count);
+        std::vector<uint32_t> stack;
+        for (uint32_t i = group_starts[count + 1]; i-- > group_starts[count];)
+            stack.push_back(children[i]);
+        while (!stack.empty())
+        {
+            uint32_t i = stack.back();
+            stack.pop_back();
+            order.push_back(i);
+            for (uint32_t child = group_starts[i + 1]; child-- > group_starts[i];)
+                stack.push_back(children[child]);
+        }
+
+        std::vector<uint32_t> new_indices(count);
+        for (uint32_t i = 0; i < count; ++i)
+            new_indices[order[i]] = i;
+
+        auto permute = [&order](auto& values)
+        {
+            auto permuted = values;
+            for (size_t i = 0; i < values.size(); ++i)
+                permuted[i] = values[order[i]];
+            values.swap(permuted);
+        };
+        permute(slots);
+        permute(parents);
+        permute(flags);
+        permute(locals);
+        permute(worlds);
+        permute(bounds);
+        permute(world_bounds);
+        permute(subtree_bounds);
+
+        std::fill(subtree_sizes.begin(), subtree_sizes.end(), 1);
+        for (uint32_t i = count; i-- > 0;)
+        {
+            if (parents[i] != NO_PARENT)
+            {
+                parents[i] = new_indices[parents[i]];
+                subtree_sizes[parents[i]] += subtree_sizes[i];
+            }
+            slot_indices[slots[i]] = i;
+        }
+
+        /* Its new ancestors may lack HAS_DIRTY even if the moved node has it. */
+        flags[new_indices[index]] &= ~HAS_DIRTY;
+        mark_dirty(new_indices[index]);
+    }
+
+    SceneNode SceneGraph::get_parent(SceneNode node) const
+    {
+        uint32_t parent = parents[get_index(node)];
+        if (parent == NO_PARENT)
+            return SceneNode();
+        return SceneNode{ slots[parent], slot_generations[slots[parent]] };
+    }
+
+    void SceneGraph::set_local(SceneNode node, const pf_math::Transform& local)
+    {
+        uint32_t index = get_index(node);
+        locals[index] = local;
+        mark_dirty(index);
+    }
+
+    void SceneGraph::set_bounds(SceneNode node, const pf_math::Rect& node_bounds)
+    {
+        uint32_t index = get_index(node);
+        bounds[index] = node_bounds;
+        /* World bounds are recomputed for every node update() visits; the world matrix stays. */
+        mark_has_dirty(index);
+    }
+
+    void SceneGraph::set_visible(SceneNode node, bool is_visible)
+    {
+        uint8_t& node_flags = flags[get_index(node)];
+        node_flags = is_visible ? node_flags & ~HIDDEN : node_flags | HIDDEN;
+    }
+
+    uint32_t SceneGraph::update()
+    {
+        uint32_t updated = 0;
+        touched.clear();
+
+        /* Parents come first, so a parent's world matrix is final when its children are reached. */
+        uint32_t count = static_cast<uint32_t>(slots.size());
+        for (uint32_t i = 0; i < count;)
+        {
+            uint32_t parent = parents[i];
+            bool is_parent_changed = parent != NO_PARENT && (flags[parent] & WORLD_CHANGED);
+            if (!is_parent_changed && !(flags[i] & HAS_DIRTY))
+            {
+                i += subtree_sizes[i];
+                continue;
+            }
+
+            if (is_parent_changed || (flags[i] & DIRTY))
+            {
+                pf_math::Mat4 local = pf_math::Mat4::from_transform(locals[i]);
+                worlds[i] = parent == NO_PARENT ? local : local * worlds[parent];
+                flags[i] |= WORLD_CHANGED;
+                ++updated;
+            }
+            touched.push_back(i);
+            ++i;
+        }
+
+        /* Children before parents, so subtree bounds gather from the leaves up. */
+        for (auto it = touched.rbegin(); it != touched.rend(); ++it)
+        {
+            uint32_t i = *it;
+            world_bounds[i] = transform_bounds(worlds[i], bounds[i]);
+            pf_math::Rect subtree = world_bounds[i];
+            for (uint32_t child = i + 1; child < i + subtree_sizes[i]; child += subtree_sizes[child])
+                subtree = unite(subtree, subtree_bounds[child]);
+            subtree_bounds[i] = subtree;
+            flags[i] &= ~(DIRTY | HAS_DIRTY | WORLD_CHANGED);
+        }
+        return updated;
+    }
+
+    void SceneGraph::cull(const pf_math::Rect& view, std::vector<SceneNode>& out_nodes) const
+    {
+        uint32_t count = static_cast<uint32_t>(slots.size());
+        for (uint32_t i = 0; i < count;)
+        {
+            if ((flags[i] & HIDDEN) || !overlaps(subtree_bounds[i], view))
+            {
+                i += subtree_sizes[i];
+                continue;
+            }
+            if (overlaps(world_bounds[i], view))
+                out_nodes.push_back(SceneNode{ slots[i], slot_generations[slots[i]] });
+            ++i;
+        }
+    }
+
+    uint32_t SceneGraph::get_index(SceneNode node) const
+    {
+        assert(contains(node));
+        return slot_indices[node.slot];
+    }
+
+    void SceneGraph::mark_dirty(uint32_t index)
+    {
+        flags[index] |= DIRTY;
+        mark_has_dirty(index);
+    }
+
+    void SceneGraph::mark_has_dirty(uint32_t index)
+    {
+        /* HAS_DIRTY on a node implies it on all its ancestors, so the walk stops at the first one. */
+        for (uint32_t i = index; i != NO_PARENT && !(flags[i] & HAS_DIRTY); i = parents[i])
+            flags[i] |= HAS_DIRTY;
+    }
+}
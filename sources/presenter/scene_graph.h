@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "common/math.h"
+
+namespace presenter
+{
+    /* Handle of a scene graph node. Stays valid while the node lives, see SceneGraph::contains(). */
+    struct SceneNode
+    {
+        uint32_t slot = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool operator==(const SceneNode& other) const { return slot == other.slot && generation == other.generation; }
+    };
+
+    /*
+     * Retained hierarchy of the presentable objects: every node has a local transform relative
+     * to its parent, and the scene graph keeps their world matrices.
+     *
+     * Nodes live in flat arrays in depth-first order, each parent before its children, so every
+     * subtree is one contiguous range. Changing a local transform only marks the node dirty,
+     * and its ancestors as having a dirty descendant; update() then walks the arrays once,
+     * skipping over clean subtrees whole, and recomputes only the dirty nodes and their
+     * descendants. A static board or deck pile so costs nothing while one card is dragged.
+     *
+     * Nodes may have bounds, a rectangle in the local x-y plane. update() also keeps the world
+     * bounds of every node and its subtree, which cull() uses to skip subtrees outside the view.
+     *
+     * Adding and removing nodes moves the nodes after them in the arrays; it is meant for
+     * setting a scene up, not for every frame.
+     */
+    class SceneGraph
+    {
+    public:
+        /* No bounds: the node itself is never visible, e.g. a group. */
+        static constexpr pf_math::Rect NO_BOUNDS = { std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(),
+            -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+
+        /* Add a node as the last child of `parent`, or as a root without one. */
+        SceneNode create(SceneNode parent = SceneNode(), const pf_math::Transform& local = pf_math::Transform(),
+            const pf_math::Rect& bounds = NO_BOUNDS);
+
+        /* Remove `node` and its subtree; their handles become invalid. */
+        void destroy(SceneNode node);
+
+        bool contains(SceneNode node) const;
+
+        /* Move `node` and its subtree to the last child of `parent`, keeping its local transform. */
+        void set_parent(SceneNode node, SceneNode parent);
+        /* The parent, or an invalid handle for a root. */
+        SceneNode get_parent(SceneNode node) const;
+
+        const pf_math::Transform& get_local(SceneNode node) const { return locals[get_index(node)]; }
+        void set_local(SceneNode node, const pf_math::Transform& local);
+
+        void set_bounds(SceneNode node, const pf_math::Rect& bounds);
+
+        /* A hidden node is culled with its subtree; its transforms are still updated. */
+        void set_visible(SceneNode node, bool is_visible);
+        bool is_visible(SceneNode node) const { return !(flags[get_index(node)] & HIDDEN); }
+
+        /* World matrix and bounds as of the last update(). */
+        const pf_math::Mat4& get_world(SceneNode node) const { return worlds[get_index(node)]; }
+        const pf_math::Rect& get_world_bounds(SceneNode node) const { return world_bounds[get_index(node)]; }
+
+        size_t get_node_count() const { return slots.size(); }
+
+        /* Bring the world matrices and bounds up to date; returns how many nodes were recomputed. */
+        uint32_t update();
+
+        /*
+         * Append the visible nodes whose world bounds overlap `view`, a rectangle of the world
+         * x-y plane, to `out_nodes`, parents before children. Call after update().
+         */
+        void cull(const pf_math::Rect& view, std::vector<SceneNode>& out_nodes) const;
+
+    private:
+        static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+        enum Flags : uint8_t
+        {
+            /* The local transform or the parent changed. */
+            DIRTY = 1,
+            /* The node or one of its descendants is dirty. */
+            HAS_DIRTY = 2,
+            /* The world matrix was recomputed in the running update(). */
+            WORLD_CHANGED = 4,
+            HIDDEN = 8,
+        };
+
+        uint32_t get_index(SceneNode node) const;
+        void mark_dirty(uint32_t index);
+        /* Flag the node and its ancestors as having something to update. */
+        void mark_has_dirty(uint32_t index);
+
+        /* Index to node, in depth-first order. */
+        std::vector<uint32_t> slots;
+        std::vector<uint32_t> parents;
+        /* Number of nodes in the subtree, the node included. */
+        std::vector<uint32_t> subtree_sizes;
+        std::vector<uint8_t> flags;
+        std::vector<pf_math::Transform> locals;
+        std::vector<pf_math::Mat4> worlds;
+        std::vector<pf_math::Rect> bounds;
+        std::vector<pf_math::Rect> world_bounds;
+        std::vector<pf_math::Rect> subtree_bounds;
+
+        /* Slot to index, and the generation of the handles to it. */
+        std::vector<uint32_t> slot_indices;
+        std::vector<uint32_t> slot_generations;
+        std::vector<uint32_t> free_slots;
+
+        /* Reused between updates. */
+        std::vector<uint32_t> touched;
+    };
+}
@@ -0,0 +1,130 @@
+#include "sprite_batch.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "presenter/glyph_atlas.h"
+#include "presenter/text_layout.h"
+
+namespace presenter
+{
+    namespace
+    {
+        constexpr int LAYER_SHIFT = 48;
+        constexpr int MATERIAL_SHIFT = 32;
+        constexpr uint64_t SPRITE_MASK = 0xffffffff;
+
+        uint64_t get_run_key(uint64_t key)
+        {
+            return key >> MATERIAL_SHIFT;
+        }
+    }
+
+    SpriteBatch::SpriteBatch(Renderer& renderer) :
+        renderer(renderer)
+    {
+    }
+
+    void SpriteBatch::add(const SpriteInstance& sprite, const MaterialData& material, int16_t layer)
+    {
+        assert(sprites.size() < SPRITE_MASK);
+
+        /* Biased, so negative layers sort first. */
+        uint64_t layer_bits = static_cast<uint16_t>(layer) ^ 0x8000u;
+        keys.push_back(layer_bits << LAYER_SHIFT | static_cast<uint64_t>(find_material(material)) << MATERIAL_SHIFT | sprites.size());
+        sprites.push_back(sprite);
+    }
+
+    void SpriteBatch::add_text(const TextLayout& layout, GlyphAtlas& atlas, const pf_math::Vec3& origin, const pf_math::Vec3& axis_x,
+        const pf_math::Vec3& axis_y, const MaterialData& material, int16_t layer)
+    {
+        pf_math::Vec3 x_step = axis_x;
+        pf_math::Vec3 y_step = axis_y;
+        for (const GlyphQuad& quad : layout.quads)
+        {
+            const GlyphRegion* region = atlas.find_glyph(quad.codepoint);
+            if (!region)
+                continue;
+
+            SpriteInstance sprite;
+            sprite.Origin = x_step * static_cast<float>(quad.x) + y_step * static_cast<float>(quad.y);
+            sprite.Origin = sprite.Origin + origin;
+            sprite.AxisX = x_step * static_cast<float>(quad.width);
+            sprite.AxisY = y_step * static_cast<float>(quad.height);
+            sprite.UVMin = pf_math::Vec2(region->u0, region->v0);
+            sprite.UVMax = pf_math::Vec2(region->u1, region->v1);
+            add(sprite, material, layer);
+        }
+    }
+
+    void SpriteBatch::flush()
+    {
+        draw_count = 0;
+        std::sort(keys.begin(), keys.end());
+
+        size_t begin = 0;
+        while (begin < keys.size())
+        {
+            size_t end = begin + 1;
+            while (end < keys.size() && get_run_key(keys[end]) == get_run_key(keys[begin]))
+                ++end;
+
+            draw(begin, end, materials[static_cast<uint16_t>(keys[begin] >> MATERIAL_SHIFT)]);
+            begin = end;
+        }
+
+        sprites.clear();
+        keys.clear();
+        materials.clear();
+    }
+
+    uint16_t SpriteBatch::find_material(const MaterialData& material)
+    {
+        /* Sprites mostly come in runs of one material, so the last one is checked first. */
+        if (!materials.empty() && materials.back() == material)
+            return static_cast<uint16_t>(materials.size() - 1);
+
+        auto it = std::find(materials.begin(), materials.end(), material);
+        if (it != materials.end())
+            return static_cast<uint16_t>(it - materials.begin());
+
+        assert(materials.size() < UINT16_MAX);
+        materials.push_back(material);
+        return static_cast<uint16_t>(materials.size() - 1);
+    }
+
+    void SpriteBatch::draw(size_t begin, size_t end, const MaterialData& material)
+    {
+        instances.clear();
+        for (size_t i = begin; i < end; ++i)
+            instances.push_back(sprites[keys[i] & SPRITE_MASK]);
+        renderer.render_instanced(instances, material);
+
+        size_t quads_per_draw = renderer.supports_instancing() ? instances.size() : Renderer::MAX_BATCH_QUADS;
+        draw_count += static_cast<uint32_t>((instances.size() + quads_per_draw - 1) / quads_per_draw);
+    }
+
+    void upload_glyph_atlas(Renderer& renderer, uint32_t texture, GlyphAtlas& atlas)
+    {
+        std::vector<uint8_t> pixels;
+        for (const AtlasRect& rect : atlas.take_dirty_rects())
+        {
+            pixels.resize(static_cast<size_t>(rect.width) * rect.height * 4);
+            uint8_t* out = pixels.data();
+            for (int y = rect.y; y < rect.y + rect.height; ++y)
+            {
+                const uint8_t* coverage = &atlas.get_pixels()[static_cast<size_t>(y) * atlas.get_width() + rect.x];
+                for (int x = 0; x < rect.width; ++x, out += 4)
+                {
+                    out[0] = 0xff;
+                    out[1] = 0xff;
+                    out[2] = 0xff;
+                    out[3] = coverage[x];
+                }
+            }
+
+            TextureData data = { pixels.data(), static_cast<uint32_t>(rect.width), static_cast<uint32_t>(rect.height) };
+            renderer.update_texture(texture, static_cast<uint32_t>(rect.x), static_cast<uint32_t>(rect.y), data);
+        }
+    }
+}
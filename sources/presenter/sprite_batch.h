@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/math.h"
+#include "presenter/renderer/renderer.h"
+
+namespace presenter
+{
+    class GlyphAtlas;
+    struct TextLayout;
+
+    /*
+     * Gathers the sprites of a frame, cards, glyphs and UI, and draws them with one draw call
+     * per layer and material instead of one per object.
+     *
+     * flush() sorts the sprites by (layer, material) and hands every run of equal keys to
+     * Renderer::render_instanced() at once, which draws them as instances or expanded into one
+     * dynamic vertex buffer. The number of draws so depends on the materials in use, not on the
+     * number of cards.
+     *
+     * Sprites keep their order within a run, but runs of one layer are drawn by material, so
+     * overlapping sprites of different materials need different layers to blend in order.
+     */
+    class SpriteBatch
+    {
+    public:
+        explicit SpriteBatch(Renderer& renderer);
+
+        /* Queue a sprite; lower layers are drawn first. */
+        void add(const SpriteInstance& sprite, const MaterialData& material, int16_t layer = 0);
+
+        /*
+         * Queue the glyphs of `layout`, its pixel (x, y) placed at origin + x * axis_x + y * axis_y.
+         * `material` names the texture `atlas` is uploaded to, see upload_glyph_atlas(). Glyphs
+         * missing from the font or the atlas are skipped.
+         */
+        void add_text(const TextLayout& layout, GlyphAtlas& atlas, const pf_math::Vec3& origin, const pf_math::Vec3& axis_x,
+            const pf_math::Vec3& axis_y, const MaterialData& material, int16_t layer = 0);
+
+        /* Draw the queued sprites, between the renderer's prepare() and present(), and clear the queue. */
+        void flush();
+
+        size_t get_sprite_count() const { return sprites.size(); }
+        /* Draw calls of the last flush(). */
+        uint32_t get_draw_count() const { return draw_count; }
+
+    private:
+        uint16_t find_material(const MaterialData& material);
+        void draw(size_t begin, size_t end, const MaterialData& material);
+
+        Renderer& renderer;
+
+        std::vector<SpriteInstance> sprites;
+        /* Per sprite: layer, material index and sprite index, so sorting them orders the sprites. */
+        std::vector<uint64_t> keys;
+        /* Materials of the queued sprites, in order of first use. */
+        std::vector<MaterialData> materials;
+
+        /* Reused between flushes. */
+        std::vector<SpriteInstance> instances;
+        uint32_t draw_count = 0;
+    };
+
+    /*
+     * Copy what changed in `atlas` since the last call to `texture`, a texture of the atlas
+     * size created with Renderer::create_texture(). The glyphs become white with their
+     * coverage as alpha, to be tinted and alpha blended. Call before flush() in every frame
+     * that adds text, as adding text may unpack glyphs.
+     */
+    void upload_glyph_atlas(Renderer& renderer, uint32_t texture, GlyphAtlas& atlas);
+}
@@ -0,0 +1,256 @@
+#include "text_layout.h"
+
+#include <algorithm>
+#include <string>
+
+namespace presenter
+{
+    namespace
+    {
+        constexpr char32_t REPLACEMENT_CHARACTER = 0xfffd;
+
+        enum class BreakClass : uint8_t
+        {
+            Alphabetic,
+            Space,
+            Hyphen,
+            Ideographic,
+            /* Never starts a line. */
+            Closing,
+            /* Never ends a line. */
+            Opening,
+        };
+
+        BreakClass get_break_class(char32_t c)
+        {
+            switch (c)
+            {
+            case U' ':
+            case U'\t':
+            case 0x3000:
+                return BreakClass::Space;
+            case U'-':
+                return BreakClass::Hyphen;
+            case U'!': case U')': case U',': case U'.': case U':': case U';': case U'?': case U']': case U'}': case U'%':
+            case 0x2019: case 0x201d: case 0x2026: case 0x3001: case 0x3002: case 0x3009: case 0x300b: case 0x300d:
+            case 0x300f: case 0x3011: case 0x3015: case 0x30fc: case 0xff01: case 0xff09: case 0xff0c: case 0xff0e:
+            case 0xff1a: case 0xff1b: case 0xff1f: case 0xff3d: case 0xff5d:
+                return BreakClass::Closing;
+            case U'(': case U'[': case U'{':
+            case 0x2018: case 0x201c: case 0x3008: case 0x300a: case 0x300c: case 0x300e: case 0x3010: case 0x3014:
+            case 0xff08: case 0xff3b: case 0xff5b:
+                return BreakClass::Opening;
+            }
+
+            /* CJK symbols, kana, ideographs, Hangul syllables, compatibility ideographs and full-width forms. */
+            if ((c >= 0x2e80 && c <= 0x9fff) || (c >= 0xac00 && c <= 0xd7af) || (c >= 0xf900 && c <= 0xfaff) ||
+                (c >= 0xff00 && c <= 0xffef) || (c >= 0x20000 && c <= 0x3ffff))
+                return BreakClass::Ideographic;
+            return BreakClass::Alphabetic;
+        }
+
+        /* Whether a line may break between `before` and `after`. */
+        bool is_break_allowed(BreakClass before, BreakClass after)
+        {
+            if (after == BreakClass::Space || after == BreakClass::Closing || before == BreakClass::Opening)
+                return false;
+            return before == BreakClass::Space || before == BreakClass::Hyphen ||
+                before == BreakClass::Ideographic || after == BreakClass::Ideographic ||
+                (before == BreakClass::Closing && after == BreakClass::Opening);
+        }
+
+        bool is_space(char32_t c)
+        {
+            return c == U' ' || c == U'\t' || c == 0x3000;
+        }
+
+        std::u32string decode_utf8(std::string_view text)
+        {
+            std::u32string result;
+            result.reserve(text.size());
+            for (size_t i = 0; i < text.size();)
+            {
+                uint8_t lead = static_cast<uint8_t>(text[i++]);
+                if (lead < 0x80)
+                {
+                    result.push_back(lead);
+                    continue;
+                }
+
+                int length = lead >= 0xf0 ? 3 : lead >= 0xe0 ? 2 : lead >= 0xc0 ? 1 : 0;
+                char32_t c = lead & (0x3f >> length);
+                int read = 0;
+                for (; read < length && i < text.size() && (static_cast<uint8_t>(text[i]) & 0xc0) == 0x80; ++read)
+                    c = c << 6 | (static_cast<uint8_t>(text[i++]) & 0x3f);
+
+                static constexpr char32_t MIN_VALUE[] = { 0, 0x80, 0x800, 0x10000 };
+                bool is_valid = length > 0 && read == length && lead < 0xf8 && c >= MIN_VALUE[length] &&
+                    c <= 0x10ffff && (c < 0xd800 || c > 0xdfff);
+                result.push_back(is_valid ? c : REPLACEMENT_CHARACTER);
+            }
+            return result;
+        }
+
+        int get_advance(const pf::BinaryFontData& font, char32_t c)
+        {
+            int index = font.find_character(c);
+            if (index >= 0)
+                return font.get_character_info(index).width;
+            /* Fonts packed from the text table have no space unless some string uses one. */
+            if (c == U' ' || c == U'\t')
+                return font.get_line_height() / 2;
+            if (c == 0x3000)
+                return font.get_line_height();
+            return 0;
+        }
+
+        struct LineRange
+        {
+            size_t begin;
+            size_t end;
+            int width;
+        };
+
+        /* Greedy line breaking: every line takes as much as fits, up to its last break opportunity. */
+        void break_lines(const pf::BinaryFontData& font, std::u32string_view text, int max_width, std::vector<LineRange>& out_lines)
+        {
+            size_t i = 0;
+            do
+            {
+                LineRange line = { i, text.size(), 0 };
+                int x = 0;
+                size_t break_index = 0;
+                int break_width = 0;
+                bool is_wrapped = false;
+
+                for (; i < text.size(); ++i)
+                {
+                    char32_t c = text[i];
+                    if (c == U'\n')
+                    {
+                        line.end = i++;
+                        break;
+                    }
+
+                    if (i > line.begin && is_break_allowed(get_break_class(text[i - 1]), get_break_class(c)))
+                    {
+                        break_index = i;
+                        break_width = line.width;
+                    }
+
+                    int advance = get_advance(font, c);
+                    if (max_width > 0 && i > line.begin && !is_space(c) && x + advance > max_width)
+                    {
+                        if (break_index > line.begin)
+                        {
+                            line.end = break_index;
+                            line.width = break_width;
+                            i = break_index;
+                        }
+                        else
+                        {
+                            line.end = i;
+                        }
+                        is_wrapped = true;
+                        break;
+                    }
+
+                    x += advance;
+                    if (!is_space(c))
+                        line.width = x;
+                }
+
+                /* Spaces a wrap falls on are dropped, as the line ends there anyway. */
+                if (is_wrapped)
+                {
+                    while (i < text.size() && is_space(text[i]))
+                        ++i;
+                }
+                out_lines.push_back(line);
+            }
+            while (i < text.size());
+        }
+    }
+
+    void layout_text(const pf::BinaryFontData& font, std::u32string_view text, int max_width, TextAlign align, TextLayout& out_layout)
+    {
+        std::vector<LineRange> ranges;
+        break_lines(font, text, max_width, ranges);
+
+        out_layout.quads.clear();
+        out_layout.lines.clear();
+        out_layout.width = max_width;
+        if (max_width <= 0)
+        {
+            out_layout.width = 0;
+            for (const LineRange& range : ranges)
+                out_layout.width = std::max(out_layout.width, range.width);
+        }
+
+        int line_height = font.get_line_height();
+        int y = 0;
+        for (const LineRange& range : ranges)
+        {
+            int x = align == TextAlign::Left ? 0 :
+                align == TextAlign::Center ? (out_layout.width - range.width) / 2 :
+                out_layout.width - range.width;
+
+            TextLine& line = out_layout.lines.emplace_back();
+            line.first_quad = static_cast<uint32_t>(out_layout.quads.size());
+            line.width = range.width;
+
+            for (size_t i = range.begin; i < range.end; ++i)
+            {
+                int index = font.find_character(text[i]);
+                if (index < 0)
+                {
+                    x += get_advance(font, text[i]);
+                    continue;
+                }
+
+                /* Glyphs of different heights share the bottom of the line. */
+                const pf::FontCharacterInfo& info = font.get_character_info(index);
+                if (!is_space(text[i]))
+                    out_layout.quads.push_back(GlyphQuad{ info.codepoint, x, y + line_height - info.height, info.width, info.height });
+                x += info.width;
+            }
+
+            line.quad_count = static_cast<uint32_t>(out_layout.quads.size()) - line.first_quad;
+            y += line_height;
+        }
+        out_layout.height = y;
+    }
+
+    void layout_text(const pf::BinaryFontData& font, std::string_view text, int max_width, TextAlign align, TextLayout& out_layout)
+    {
+        layout_text(font, decode_utf8(text), max_width, align, out_layout);
+    }
+
+    size_t TextLayoutCache::KeyHash::operator()(const Key& key) const
+    {
+        uint64_t value = reinterpret_cast<uintptr_t>(key.font);
+        value = value * 0x9e3779b97f4a7c15ull ^ key.text_id;
+        value = value * 0x9e3779b97f4a7c15ull ^ static_cast<uint32_t>(key.max_width);
+        value = value * 0x9e3779b97f4a7c15ull ^ static_cast<uint8_t>(key.align);
+        return static_cast<size_t>(value ^ value >> 32);
+    }
+
+    template<typename String>
+    const TextLayout& TextLayoutCache::get_layout(uint32_t text_id, const pf::BinaryFontData& font, int max_width, TextAlign align, String text)
+    {
+        auto [it, is_new] = layouts.try_emplace(Key{ &font, text_id, max_width, align });
+        if (is_new)
+            layout_text(font, text, max_width, align, it->second);
+        return it->second;
+    }
+
+    const TextLayout& TextLayoutCache::get(uint32_t text_id, const pf::BinaryFontData& font, int max_width, TextAlign align, std::string_view text)
+    {
+        return get_layout(text_id, font, max_width, align, text);
+    }
+
+    const TextLayout& TextLayoutCache::get(uint32_t text_id, const pf::BinaryFontData& font, int max_width, TextAlign align, std::u32string_view text)
+    {
+        return get_layout(text_id, font, max_width, align, text);
+    }
+}
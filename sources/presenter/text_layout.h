@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "data/binary_font_data.h"
+#include "data/binary_text_data.h"
+
+namespace presenter
+{
+    enum class TextAlign : uint8_t
+    {
+        Left,
+        Center,
+        Right,
+    };
+
+    /*
+     * A glyph placed by the layout, in pixels from the top left corner of the text box. It
+     * names the codepoint rather than an atlas region: the layout outlives frames, atlas
+     * regions do not, see GlyphAtlas::find_glyph().
+     */
+    struct GlyphQuad
+    {
+        uint32_t codepoint;
+        int32_t x;
+        int32_t y;
+        uint8_t width;
+        uint8_t height;
+    };
+
+    struct TextLine
+    {
+        uint32_t first_quad;
+        uint32_t quad_count;
+        /* Width of the line without its trailing spaces. */
+        int width;
+    };
+
+    struct TextLayout
+    {
+        /* Visible glyphs only; spaces and line breaks have no quad. */
+        std::vector<GlyphQuad> quads;
+        std::vector<TextLine> lines;
+        /* Size of the text box: the wrap width, or the widest line when there is none. */
+        int width = 0;
+        int height = 0;
+    };
+
+    /*
+     * Lay `text` out with `font`, wrapping lines at `max_width` pixels, or only at '\n' when
+     * `max_width` is 0 or less. The advance of a glyph is its width, as in the pixel fonts
+     * the resource packer takes; a character the font lacks takes no space.
+     *
+     * Lines break after spaces and hyphens and before or after any CJK character, except
+     * that closing punctuation never starts a line and opening punctuation never ends one.
+     * A word wider than the line is broken where it overflows.
+     */
+    void layout_text(const pf::BinaryFontData& font, std::u32string_view text, int max_width, TextAlign align, TextLayout& out_layout);
+
+    /* Same for UTF-8 text, e.g. from the text table. Malformed sequences become U+FFFD. */
+    void layout_text(const pf::BinaryFontData& font, std::string_view text, int max_width, TextAlign align, TextLayout& out_layout);
+
+    /*
+     * Layouts of the text table's strings, keyed by (text id, font, width, alignment), so a
+     * static label is laid out once instead of every frame. Dynamic text such as scores should
+     * call layout_text() directly. The text of an id must not change while it is cached;
+     * clear() the cache when it does. Layouts of a BinaryTextData are also keyed by language.
+     */
+    class TextLayoutCache
+    {
+    public:
+        /* Layout of `id` in the current language of `texts`. Valid until clear(). */
+        const TextLayout& get(pf::TextId id, const pf::BinaryTextData& texts, const pf::BinaryFontData& font, int max_width, TextAlign align)
+        {
+            uint32_t text_id = static_cast<uint32_t>(texts.get_language()) << 16 | static_cast<uint32_t>(id);
+            return get(text_id, font, max_width, align, texts.get_text(id));
+        }
+
+        /* Layout of text `text_id`, laid out from `text` on a miss. Valid until clear(). */
+        const TextLayout& get(uint32_t text_id, const pf::BinaryFontData& font, int max_width, TextAlign align, std::string_view text);
+        const TextLayout& get(uint32_t text_id, const pf::BinaryFontData& font, int max_width, TextAlign align, std::u32string_view text);
+
+        void clear() { layouts.clear(); }
+        size_t get_size() const { return layouts.size(); }
+
+    private:
+        struct Key
+        {
+            const pf::BinaryFontData* font;
+            uint32_t text_id;
+            int32_t max_width;
+            TextAlign align;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+
+        template<typename String>
+        const TextLayout& get_layout(uint32_t text_id, const pf::BinaryFontData& font, int max_width, TextAlign align, String text);
+
+        /* Node based, so references to layouts stay valid as the map grows. */
+        std::unordered_map<Key, TextLayout, KeyHash> layouts;
+    };
+}
@@ -0,0 +1,138 @@
+"""
+Content-hash build cache of the resource packer, kept in a directory next to the pack:
+
+    manifest.json   {"version": 2,
+                     "files": {path: [size, mtime_ns, sha256]},
+                     "packers": {resource name: {"key": sha256, "blob": file name,
+                                                 "code": {"name", "source"} of the generated
+                                                 code, or null}},
+                     "pack": sha256 key of the last written pack, or null}
+    *.bin           the last output of every packer
+
+A packer's key hashes its source, the packer base, the code generator and every input file, so a packer runs
+again only when one of those changed. File hashes are reused while a file keeps its size and
+modification time, so an unchanged input tree is only stat'ed, never read.
+
+The pack's own key hashes the pack writer, its compressor and the key of every packer, so a
+change to the container format rewrites the pack even when no packer has to run again.
+"""
+
+from __future__ import annotations
+import hashlib
+import inspect
+import json
+import os
+from typing import TYPE_CHECKING
+
+import code_gen.cpp_code_gen
+import lz4_block
+import pack_writer
+import packer_base
+
+if TYPE_CHECKING:
+    from typing import Dict, List, Optional
+    from packer_base import PackerBase
+
+MANIFEST_VERSION = 2
+MANIFEST_FILENAME = 'manifest.json'
+
+
+def list_input_files(paths: List[str]) -> List[str]:
+    """Files of `paths`, directories expanded recursively, sorted so the order never changes a key."""
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for dirpath, dirnames, filenames in os.walk(path):
+                dirnames[:] = [name for name in dirnames if not name.startswith('.')]
+                files.extend(os.path.join(dirpath, name) for name in filenames if not name.startswith('.'))
+        elif os.path.isfile(path):
+            files.append(path)
+        else:
+            raise FileNotFoundError('Missing packer input: %s' % path)
+    return sorted(os.path.normpath(file) for file in files)
+
+
+class BuildCache:
+    def __init__(self, cache_dir: str):
+        self.cache_dir = cache_dir
+        self.files: Dict[str, list] = {}
+        self.packers: Dict[str, dict] = {}
+        self.pack_key: Optional[str] = None
+        self.used_files = set()
+
+        try:
+            with open(os.path.join(cache_dir, MANIFEST_FILENAME), 'r', encoding='utf-8') as f:
+                manifest = json.load(f)
+            if manifest.get('version') == MANIFEST_VERSION:
+                self.files = manifest['files']
+                self.packers = manifest['packers']
+                self.pack_key = manifest['pack']
+        except (OSError, ValueError, KeyError):
+            pass
+
+    def hash_file(self, path: str) -> str:
+        self.used_files.add(path)
+        stat = os.stat(path)
+        known = self.files.get(path)
+        if known is not None and known[0] == stat.st_size and known[1] == stat.st_mtime_ns:
+            return known[2]
+
+        digest = hashlib.sha256()
+        with open(path, 'rb') as f:
+            for block in iter(lambda: f.read(1 << 20), b''):
+                digest.update(block)
+        self.files[path] = [stat.st_size, stat.st_mtime_ns, digest.hexdigest()]
+        return digest.hexdigest()
+
+    def get_key(self, packer: PackerBase, input_files: List[str]) -> str:
+        digest = hashlib.sha256()
+        sources = {inspect.getsourcefile(module) for module in (inspect.getmodule(type(packer)), packer_base, code_gen.cpp_code_gen)}
+        for source in sorted(sources):
+            digest.update(self.hash_file(source).encode())
+        for path in input_files:
+            digest.update(os.path.relpath(path, packer.project_dir).replace(os.sep, '/').encode('utf-8'))
+            digest.update(self.hash_file(path).encode())
+        return digest.hexdigest()
+
+    def get_pack_key(self, packer_keys: Dict[str, str]) -> str:
+        digest = hashlib.sha256()
+        for module in (pack_writer, lz4_block):
+            digest.update(self.hash_file(inspect.getsourcefile(module)).encode())
+        for name in sorted(packer_keys):
+            digest.update(name.encode('utf-8'))
+            digest.update(packer_keys[name].encode())
+        return digest.hexdigest()
+
+    def get_blob_path(self, name: str) -> str:
+        return os.path.join(self.cache_dir, hashlib.sha256(name.encode('utf-8')).hexdigest()[:16] + '.bin')
+
+    def is_fresh(self, name: str, key: str) -> bool:
+        entry = self.packers.get(name)
+        return entry is not None and entry['key'] == key and os.path.isfile(self.get_blob_path(name))
+
+    def load(self, name: str) -> bytes:
+        with open(self.get_blob_path(name), 'rb') as f:
+            return f.read()
+
+    def get_code(self, name: str) -> Optional[dict]:
+        return self.packers[name]['code']
+
+    def store(self, name: str, key: str, blob: bytes, code: Optional[dict]) -> None:
+        os.makedirs(self.cache_dir, exist_ok=True)
+        with open(self.get_blob_path(name), 'wb') as f:
+            f.write(blob)
+        self.packers[name] = {'key': key, 'blob': os.path.basename(self.get_blob_path(name)), 'code': code}
+
+    def save(self, names: List[str], is_complete: bool = True) -> None:
+        """
+        Write the manifest. After a run of every packer, forget packers not in `names` and files
+        no packer used; a partial run keeps everything it did not see.
+        """
+        if is_complete:
+            self.packers = {name: entry for name, entry in self.packers.items() if name in names}
+            self.files = {path: entry for path, entry in self.files.items() if path in self.used_files}
+        os.makedirs(self.cache_dir, exist_ok=True)
+        path = os.path.join(self.cache_dir, MANIFEST_FILENAME)
+        with open(path + '.tmp', 'w', encoding='utf-8') as f:
+            json.dump({'version': MANIFEST_VERSION, 'files': self.files, 'packers': self.packers, 'pack': self.pack_key}, f, indent=1, sort_keys=True)
+        os.replace(path + '.tmp', path)
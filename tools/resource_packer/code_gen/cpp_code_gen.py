@@ -1,27 +1,75 @@
-from code_gen_base import CodeGen, CodeGenContainer
+import textwrap
+
+from code_gen.code_gen_base import CodeGen, CodeGenContainer
 
 
 class CppCodeGen(CodeGenContainer):
     def __init__(self, name, namespace=None):
         super().__init__(name, 0)
         self.namespace = namespace
+        self.includes = []
 
     def iter_lines(self):
+        yield '/* Generated by tools/resource_packer, do not edit. */'
+        yield ''
+        yield '#pragma once'
+        yield ''
+        for include in self.includes:
+            yield '#include %s' % include
+        if self.includes:
+            yield ''
+
         indent_count = 0
         if self.namespace is not None:
             yield 'namespace %s' % self.namespace
             yield '{'
             indent_count += 1
-        for content in self.iter_contents():
+        for i, content in enumerate(self.iter_contents()):
+            if i > 0:
+                yield ''
             for line in content.iter_lines():
-                yield '\t' * indent_count + line
+                yield '\t' * indent_count + line if line else line
         if self.namespace is not None:
             yield '}'
             indent_count -= 1
 
+    def add_include(self, header):
+        """`header` with its brackets or quotes, e.g. '<cstdint>'."""
+        if header not in self.includes:
+            self.includes.append(header)
+
     def add_constexpr(self, name, typename, value):
         self.add(CppConstexpr(name, typename, value))
 
+    def add_enum(self, name, underlying_type, values):
+        self.add(CppEnum(name, underlying_type, values))
+
+    def add_function(self, name, signature, plain_text, priority=50):
+        """A lower priority puts the function first, e.g. before the functions calling it."""
+        self.add(CppFunction(name, signature, plain_text, priority))
+
+    def get_source(self):
+        return ''.join(line + '\n' for line in self.iter_lines())
+
+    def write(self, filename):
+        with open(filename, 'w', encoding='utf-8', newline='\n') as f:
+            f.write(self.get_source())
+
+
+class CppEnum(CodeGen):
+    def __init__(self, name, underlying_type, values):
+        """`values` are (name, value) pairs."""
+        super().__init__(name, 0)
+        self.underlying_type = underlying_type
+        self.values = values
+
+    def iter_lines(self):
+        yield 'enum class %s : %s' % (self.name, self.underlying_type)
+        yield '{'
+        for name, value in self.values:
+            yield '\t%s = %s,' % (name, value)
+        yield '};'
+
 
 class CppVariable(CodeGen):
     def __init__(self, name, typename, value):
@@ -45,16 +93,17 @@ class CppConstexpr(CodeGen):
 
 
 class CppFunction(CodeGen):
-    def __init__(self, name: str, signature: str, plain_text: str):
-        super().__init__(name, 50)
+    def __init__(self, name: str, signature: str, plain_text: str, priority: int = 50):
+        super().__init__(name, priority)
         self.signature = signature
         self.plain_text = plain_text
 
     def iter_lines(self):
         yield self.signature
         yield '{'
-        for line in self.plain_text.split('\n'):
-            yield '\t' + line.strip()
+        for line in textwrap.dedent(self.plain_text).strip('\n').split('\n'):
+            stripped = line.lstrip(' ')
+            yield ('\t' * (1 + (len(line) - len(stripped)) // 4) + stripped).rstrip()
         yield '}'
 
 
@@ -0,0 +1,96 @@
+"""
+LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md), greedy
+matching over a hash of 4-byte sequences. The C++ side only decompresses, see
+sources/io/lz4.h; decompress() here is for checking the output.
+"""
+
+MIN_MATCH = 4
+# The last match must start at least 12 bytes before the end and the last 5 bytes are literals.
+MATCH_FIND_LIMIT = 12
+LAST_LITERALS = 5
+MAX_OFFSET = 0xffff
+
+
+def _write_length(out: bytearray, length: int) -> None:
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _write_sequence(out: bytearray, literals: bytes, match_length: int, offset: int) -> None:
+    literal_length = len(literals)
+    token = min(literal_length, 15) << 4
+    if match_length:
+        token |= min(match_length - MIN_MATCH, 15)
+    out.append(token)
+    if literal_length >= 15:
+        _write_length(out, literal_length - 15)
+    out += literals
+    if match_length:
+        out += offset.to_bytes(2, 'little')
+        if match_length - MIN_MATCH >= 15:
+            _write_length(out, match_length - MIN_MATCH - 15)
+
+
+def compress(data: bytes) -> bytes:
+    out = bytearray()
+    size = len(data)
+    table = {}
+    anchor = 0
+    position = 0
+    match_limit = size - MATCH_FIND_LIMIT
+
+    while position < match_limit:
+        key = data[position:position + MIN_MATCH]
+        candidate = table.get(key, -1)
+        table[key] = position
+        if candidate < 0 or position - candidate > MAX_OFFSET:
+            position += 1
+            continue
+
+        match_length = MIN_MATCH
+        end_limit = size - LAST_LITERALS
+        while position + match_length < end_limit and data[candidate + match_length] == data[position + match_length]:
+            match_length += 1
+
+        _write_sequence(out, data[anchor:position], match_length, position - candidate)
+        position += match_length
+        anchor = position
+
+    _write_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def _read_length(data: bytes, position: int, length: int):
+    if length != 15:
+        return length, position
+    while True:
+        byte = data[position]
+        position += 1
+        length += byte
+        if byte != 255:
+            return length, position
+
+
+def decompress(data: bytes, raw_size: int) -> bytes:
+    out = bytearray()
+    position = 0
+    while True:
+        token = data[position]
+        position += 1
+        literal_length, position = _read_length(data, position, token >> 4)
+        out += data[position:position + literal_length]
+        position += literal_length
+        if position >= len(data):
+            break
+        offset = int.from_bytes(data[position:position + 2], 'little')
+        position += 2
+        match_length, position = _read_length(data, position, token & 15)
+        match_length += MIN_MATCH
+        start = len(out) - offset
+        for i in range(match_length):
+            out.append(out[start + i])
+    if len(out) != raw_size:
+        raise ValueError('LZ4 block decodes to %d bytes instead of %d' % (len(out), raw_size))
+    return bytes(out)
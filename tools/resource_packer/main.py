@@ -1,18 +1,144 @@
+"""
+Packs the game's resources into resources.pfpk and writes the code generated along the way
+to sources/define.
+
+Packers run only when their inputs changed since the last run, see build_cache.py, and
+independent packers run in parallel processes. Outputs are rewritten only when their content
+changes, so an up-to-date run touches nothing and dependent build steps stay quiet.
+
+The build runs the packer twice: --mode code writes the generated code only, which the C++
+sources include and which needs neither Pillow nor the fonts, and --mode pack writes the pack.
+"""
+
 import argparse
+import os
+import time
+from concurrent.futures import ProcessPoolExecutor
+
+from build_cache import BuildCache, list_input_files
+from pack_writer import write_pack
+from text_table_packer import TextTablePacker
+
+PACK_FILENAME = 'resources.pfpk'
+CACHE_DIRNAME = '.pack_cache'
+
+
+GENERATED_CODE_DIR = 'sources/define'
+
+
+def run_packer(packer):
+    """Runs in a worker process; returns the resource and the generated code, if any."""
+    start = time.perf_counter()
+    blob = bytes(packer.pack())
+    code = None
+    if packer.generated_code is not None:
+        code = {'name': packer.generated_code.name, 'source': packer.generated_code.get_source()}
+    return blob, code, time.perf_counter() - start
+
+
+def write_if_changed(path, data: bytes) -> bool:
+    try:
+        with open(path, 'rb') as f:
+            if f.read() == data:
+                return False
+    except OSError:
+        pass
+    with open(path + '.tmp', 'wb') as f:
+        f.write(data)
+    os.replace(path + '.tmp', path)
+    return True
+
 
-from text_packer import TextPacker
+def write_depfile(path, targets, input_files):
+    """Makefile syntax, as CMake's DEPFILE reads it."""
+    def escape(file):
+        return os.path.abspath(file).replace('\\', '/').replace(' ', '\\ ').replace('#', '\\#').replace('$', '$$')
 
+    write_if_changed(path, ('%s: \\\n' % ' '.join(escape(target) for target in targets) + ' \\\n'.join(' ' + escape(file) for file in input_files) + '\n').encode('utf-8'))
 
-def start_packing(project_dir):
-    packers = [
+
+def create_packers(project_dir, mode):
+    """The packers `mode` runs. Code generation needs neither Pillow nor the font checkout."""
+    if mode == 'code':
+        return [TextTablePacker(project_dir)]
+
+        return [
         TextPacker(project_dir),
+        TextTablePacker(project_dir),
     ]
 
 
+def start_packing(project_dir, output_bin_dir, output_code_dir, depfile=None, jobs=None, mode='all'):
+    packers = create_packers(project_dir, mode)
+
+    cache = BuildCache(os.path.join(output_bin_dir, CACHE_DIRNAME))
+    keys = {}
+    all_inputs = set()
+    dirty = []
+    for packer in packers:
+        name = packer.get_resource_name()
+        input_files = list_input_files(packer.get_required_resources())
+        all_inputs.update(input_files)
+        keys[name] = cache.get_key(packer, input_files)
+        if cache.is_fresh(name, keys[name]):
+            print('%s: up to date' % name)
+        else:
+            dirty.append(packer)
+
+    if len(dirty) > 1 and jobs != 1:
+        with ProcessPoolExecutor(jobs) as executor:
+            results = list(executor.map(run_packer, dirty))
+    else:
+        results = [run_packer(packer) for packer in dirty]
+
+    for packer, (blob, code, seconds) in zip(dirty, results):
+        name = packer.get_resource_name()
+        cache.store(name, keys[name], blob, code)
+        print('%s: packed %d bytes in %.2f s' % (name, len(blob), seconds))
+
+    names = [packer.get_resource_name() for packer in packers]
+    outputs = []
+
+    if mode != 'code':
+        pack_key = cache.get_pack_key(keys)
+        os.makedirs(output_bin_dir, exist_ok=True)
+        pack_path = os.path.join(output_bin_dir, PACK_FILENAME)
+        if pack_key != cache.pack_key or not os.path.isfile(pack_path):
+            write_pack(pack_path, {name: cache.load(name) for name in names})
+            cache.pack_key = pack_key
+        else:
+            # Inputs were touched without changing; mark the pack current for the build system.
+            os.utime(pack_path)
+        outputs.append(pack_path)
+
+    if mode != 'pack':
+        code_dir = os.path.join(output_code_dir, GENERATED_CODE_DIR)
+        os.makedirs(code_dir, exist_ok=True)
+        for packer in packers:
+            code = cache.get_code(packer.get_resource_name())
+            if code is None:
+                continue
+            code_path = os.path.join(code_dir, code['name'] + '.generated.h')
+            if not write_if_changed(code_path, code['source'].encode('utf-8')) and mode == 'code':
+                # As for the pack; the build system reruns a step whose output is older than its inputs.
+                os.utime(code_path)
+            outputs.append(code_path)
+
+    # A code run sees only some of the packers; it keeps the cache entries of the others.
+    cache.save(names, is_complete=mode != 'code')
+
+    if depfile:
+        write_depfile(depfile, outputs, sorted(all_inputs))
+
+
 if __name__ == '__main__':
     parser = argparse.ArgumentParser()
     parser.add_argument('--project-dir', type=str, default='../..')
     parser.add_argument('--output-bin-dir', type=str, default='../..')
     parser.add_argument('--output-code-dir', type=str, default='../..')
+    parser.add_argument('--mode', choices=('all', 'code', 'pack'), default='all',
+                        help='code writes only the generated code, pack only the pack')
+    parser.add_argument('--depfile', type=str, default=None, help='write the inputs of the outputs for the build system')
+    parser.add_argument('--jobs', type=int, default=None, help='packer processes, one per core by default')
     args = parser.parse_args()
-    start_packing(args.project_dir)
+    start_packing(args.project_dir, args.output_bin_dir, args.output_code_dir, args.depfile, args.jobs, args.mode)
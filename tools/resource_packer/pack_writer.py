@@ -0,0 +1,123 @@
+"""
+Resource pack container, read by sources/io/pack_reader.h. Little endian:
+
+    header      magic 'PFPK', uint32 version, uint32 toc offset, uint32 bucket count,
+                uint32 resource count, uint32 data alignment
+    toc         bucket count entries of (uint64 id, uint32 offset, uint32 stored size,
+                uint32 size, uint16 codec, uint16 reserved), an open addressing hash table
+                with linear probing; id 0 marks an empty bucket
+    data        resource blobs, each starting on a multiple of the data alignment
+
+A resource id is the 64-bit FNV-1a hash of its UTF-8 name and its bucket is id & (bucket count - 1).
+
+Codec 0 stores the resource as is. Codec 1 splits it into chunks of a fixed size that are
+compressed independently, so they can be decompressed in parallel:
+
+    uint32 chunk size, uint32 chunk count
+    uint32 stored size of every chunk; bit 31 set when the chunk is stored uncompressed
+    chunk data back to back, LZ4 blocks or raw bytes
+"""
+
+from __future__ import annotations
+import struct
+from typing import TYPE_CHECKING
+
+import lz4_block
+
+if TYPE_CHECKING:
+    from typing import Dict
+
+
+PACK_MAGIC = b'PFPK'
+PACK_VERSION = 2
+HEADER_FORMAT = '<4sIIIII'
+TOC_ENTRY_FORMAT = '<QIIIHH'
+DATA_ALIGNMENT = 16
+
+CODEC_NONE = 0
+CODEC_LZ4_CHUNKS = 1
+CHUNK_SIZE = 64 * 1024
+CHUNK_STORED_FLAG = 0x80000000
+
+FNV_OFFSET_BASIS = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+
+
+def hash_resource_name(name: str) -> int:
+    value = FNV_OFFSET_BASIS
+    for byte in name.encode('utf-8'):
+        value = ((value ^ byte) * FNV_PRIME) & 0xffffffffffffffff
+    return value
+
+
+def align(value: int, alignment: int) -> int:
+    return (value + alignment - 1) // alignment * alignment
+
+
+def encode_resource(blob: bytes):
+    """Return (codec, stored bytes). A chunk is kept compressed only when it saves at least 1/16."""
+
+    chunk_sizes = []
+    chunk_data = bytearray()
+    is_any_compressed = False
+    for start in range(0, len(blob), CHUNK_SIZE):
+        chunk = blob[start:start + CHUNK_SIZE]
+        compressed = lz4_block.compress(chunk)
+        if len(compressed) <= len(chunk) - len(chunk) // 16 - 1:
+            chunk_sizes.append(len(compressed))
+            chunk_data += compressed
+            is_any_compressed = True
+        else:
+            chunk_sizes.append(len(chunk) | CHUNK_STORED_FLAG)
+            chunk_data += chunk
+
+    if not is_any_compressed:
+        return CODEC_NONE, blob
+
+    header = struct.pack('<II', CHUNK_SIZE, len(chunk_sizes)) + struct.pack('<%dI' % len(chunk_sizes), *chunk_sizes)
+    return CODEC_LZ4_CHUNKS, header + chunk_data
+
+
+def build_pack(resources: Dict[str, bytes]) -> bytearray:
+    ids = {}
+    for name in resources:
+        resource_id = hash_resource_name(name)
+        if resource_id == 0 or resource_id in ids:
+            raise ValueError('Resource id of %s is reserved or collides with %s' % (name, ids.get(resource_id)))
+        ids[resource_id] = name
+
+    """Keep the table at most half full so probes stay short"""
+
+    bucket_count = 1
+    while bucket_count < len(resources) * 2:
+        bucket_count *= 2
+
+    toc_offset = struct.calcsize(HEADER_FORMAT)
+    data_offset = align(toc_offset + bucket_count * struct.calcsize(TOC_ENTRY_FORMAT), DATA_ALIGNMENT)
+
+    buckets = [(0, 0, 0, 0, 0, 0)] * bucket_count
+    data = bytearray()
+    for resource_id, name in sorted(ids.items(), key=lambda item: item[1]):
+        blob = resources[name]
+        codec, stored = encode_resource(blob)
+        data += bytes(align(len(data), DATA_ALIGNMENT) - len(data))
+        entry = (resource_id, data_offset + len(data), len(stored), len(blob), codec, 0)
+        data += stored
+
+        bucket = resource_id & (bucket_count - 1)
+        while buckets[bucket][0] != 0:
+            bucket = (bucket + 1) & (bucket_count - 1)
+        buckets[bucket] = entry
+
+    packed = bytearray(struct.pack(HEADER_FORMAT, PACK_MAGIC, PACK_VERSION, toc_offset, bucket_count,
+                                   len(resources), DATA_ALIGNMENT))
+    for entry in buckets:
+        packed += struct.pack(TOC_ENTRY_FORMAT, *entry)
+    packed += bytes(data_offset - len(packed))
+    packed += data
+    return packed
+
+
+def write_pack(path: str, resources: Dict[str, bytes]) -> None:
+    with open(path, 'wb') as f:
+        f.write(build_pack(resources))
@@ -22,6 +22,10 @@ class PackerBase(metaclass=abc.ABCMeta):
         self.generated_code = code_gen.cpp(name, 'pf')
         return self.generated_code
 
+    @abc.abstractmethod
+    def get_resource_name(self) -> str:
+        pass
+
     @abc.abstractmethod
     def pack(self) -> bytearray:
         pass
@@ -1,15 +1,23 @@
 import csv
 import os
+import struct
 from typing import List
 
 from PIL import Image
 
 from packer_base import PackerBase
 
+GLYPH_DIR = 'external/ark-pixel-font/assets/glyphs/12'
+
 
 class TextPacker(PackerBase):
+    def get_resource_name(self) -> str:
+        return 'font'
+
+    def get_required_resources(self) -> List[str]:
+        return [self.get_path(GLYPH_DIR), self.get_path('resources/data_table/text.csv')]
+
     def pack(self) -> bytearray:
-        font_path = self.get_path('external/ark-pixel-font')
         text_csv_filename = self.get_path('resources/data_table/text.csv')
 
         """Collect charset"""
@@ -26,7 +34,7 @@ class TextPacker(PackerBase):
 
         not_def_path = None
         font_png_paths = {}
-        for dirpath, _, filenames in os.walk(os.path.join(font_path, 'assets/glyphs/12')):
+        for dirpath, _, filenames in os.walk(self.get_path(GLYPH_DIR)):
             for filename in filenames:
                 if not filename.endswith('.png'):
                     continue
@@ -65,15 +73,15 @@ class TextPacker(PackerBase):
                 raw_datas[char] = raw_data
                 raw_data_shapes[char] = font_image.size
 
-        """Pack font data"""
+        """Pack font data, see sources/data/binary_font_data.h for the layout"""
 
         packed_header = bytearray()
         packed_data = bytearray()
 
-        for char, raw_data in raw_datas.items():
-            packed_header.append(len(packed_data))
-            packed_header.append(raw_data_shapes[char][0])
-            packed_header.append(raw_data_shapes[char][1])
+        for char in sorted(raw_datas.keys(), key=ord):
+            raw_data = raw_datas[char]
+            width, height = raw_data_shapes[char]
+            packed_header += struct.pack('<IIBBH', ord(char), len(packed_data), width, height, 0)
 
             pack_byte = 0
             for i in range(len(raw_data)):
@@ -87,8 +95,7 @@ class TextPacker(PackerBase):
             if len(raw_data) % 8 != 0:
                 packed_data.append(pack_byte << 8 - len(raw_data) % 8)
 
-        packed_header.insert(0, len(packed_header))
-        packed_data = packed_header + packed_data
+        packed_data = struct.pack('<II', len(raw_datas), len(packed_data)) + packed_header + packed_data
 
         return packed_data
 
@@ -99,6 +106,3 @@ class TextPacker(PackerBase):
         #
         # with open('../../resources/packed/font.bin', 'wb') as f:
         #     f.write(packed_data)
-
-    def get_required_resources(self) -> List[str]:
-        pass
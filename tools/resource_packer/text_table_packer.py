@@ -0,0 +1,161 @@
+"""
+Text table, read by sources/data/binary_text_data.h. Little endian:
+
+    uint32 language count, uint32 string count, uint32 string pool size
+    (uint32 offset, uint32 length) per string and language, language major
+    string pool: UTF-8, every string followed by a NUL; equal strings are stored once
+
+Also generates sources/define/text_id.generated.h: a TextId per key of the table, in table
+order, a TextLanguage per language column, and find_text_id(), a constexpr minimal perfect
+hash from key to id.
+"""
+
+from __future__ import annotations
+import csv
+import struct
+from typing import TYPE_CHECKING
+
+from packer_base import PackerBase
+
+if TYPE_CHECKING:
+    from typing import Dict, List, Tuple
+
+FNV_OFFSET_BASIS = 0x811c9dc5
+FNV_PRIME = 0x01000193
+MAX_SEED = 1 << 20
+
+
+def hash_text_key(key: str, seed: int) -> int:
+    """
+    32-bit FNV-1a of the UTF-8 key with the seed mixed into the basis, then the murmur3
+    finalizer, without which the low bits would not depend on the seed. Mirrors the generated C++.
+    """
+    value = FNV_OFFSET_BASIS ^ seed
+    for byte in key.encode('utf-8'):
+        value = ((value ^ byte) * FNV_PRIME) & 0xffffffff
+    value ^= value >> 16
+    value = (value * 0x85ebca6b) & 0xffffffff
+    value ^= value >> 13
+    value = (value * 0xc2b2ae35) & 0xffffffff
+    return value ^ value >> 16
+
+
+def build_perfect_hash(keys: List[str]) -> Tuple[List[int], List[int]]:
+    """
+    Hash and displace: keys go to buckets by hash_text_key(key, 0) % n. Buckets are placed
+    largest first; a bucket of several keys gets the first seed that sends all of them to
+    free distinct slots with hash_text_key(key, seed) % n, a single key takes any free slot
+    directly, stored as -slot - 1. Returns the seed of every bucket and the key index of
+    every slot.
+    """
+    n = len(keys)
+    buckets = [[] for _ in range(n)]
+    for index, key in enumerate(keys):
+        buckets[hash_text_key(key, 0) % n].append(index)
+
+    seeds = [0] * n
+    slots = [-1] * n
+    order = sorted(range(n), key=lambda b: -len(buckets[b]))
+    for bucket in order:
+        members = buckets[bucket]
+        if len(members) <= 1:
+            break
+        for seed in range(1, MAX_SEED):
+            placed = [hash_text_key(keys[index], seed) % n for index in members]
+            if len(set(placed)) == len(placed) and all(slots[slot] < 0 for slot in placed):
+                break
+        else:
+            raise RuntimeError('No perfect hash seed found for %s' % [keys[index] for index in members])
+        seeds[bucket] = seed
+        for index, slot in zip(members, placed):
+            slots[slot] = index
+
+    free_slots = [slot for slot in range(n) if slots[slot] < 0]
+    for bucket in order:
+        if len(buckets[bucket]) == 1:
+            slot = free_slots.pop()
+            seeds[bucket] = -slot - 1
+            slots[slot] = buckets[bucket][0]
+    return seeds, slots
+
+
+def get_language_name(language: str) -> str:
+    return language.upper().replace('-', '_')
+
+
+class TextTablePacker(PackerBase):
+    def get_resource_name(self) -> str:
+        return 'text'
+
+    def get_required_resources(self) -> List[str]:
+        return [self.get_path('resources/data_table/text.csv')]
+
+    def read_table(self) -> Tuple[List[str], List[str], Dict[str, List[str]]]:
+        with open(self.get_path('resources/data_table/text.csv'), 'r', encoding='utf-8') as f:
+            reader = csv.DictReader(f)
+            languages = [header for header in reader.fieldnames if header != 'key']
+            keys = []
+            texts = {language: [] for language in languages}
+            for row in reader:
+                key = row['key']
+                if not key.isidentifier() or key in keys:
+                    raise ValueError('Invalid or duplicate text key: %s' % key)
+                keys.append(key)
+                for language in languages:
+                    texts[language].append(row[language] or '')
+        return keys, languages, texts
+
+    def pack(self) -> bytearray:
+        keys, languages, texts = self.read_table()
+        self.generate_text_ids(keys, languages)
+
+        pool = bytearray()
+        pool_offsets = {}
+        entries = bytearray()
+        for language in languages:
+            for text in texts[language]:
+                data = text.encode('utf-8')
+                if data not in pool_offsets:
+                    pool_offsets[data] = len(pool)
+                    pool += data + b'\0'
+                entries += struct.pack('<II', pool_offsets[data], len(data))
+
+        return bytearray(struct.pack('<III', len(languages), len(keys), len(pool))) + entries + pool
+
+    def generate_text_ids(self, keys: List[str], languages: List[str]) -> None:
+        code = self.generate_code('text_id')
+        code.add_include('<cstdint>')
+        code.add_include('<optional>')
+        code.add_include('<string_view>')
+
+        code.add_enum('TextLanguage', 'uint8_t', [(get_language_name(language), i) for i, language in enumerate(languages)])
+        code.add_enum('TextId', 'uint16_t', [(key, i) for i, key in enumerate(keys)])
+        code.add_constexpr('TEXT_LANGUAGE_COUNT', 'uint32_t', len(languages))
+        code.add_constexpr('TEXT_ID_COUNT', 'uint32_t', len(keys))
+
+        if not keys:
+            code.add_function('find_text_id', 'constexpr std::optional<TextId> find_text_id(std::string_view key)', '''
+                (void)key;
+                return std::nullopt;''')
+            return
+
+        seeds, slots = build_perfect_hash(keys)
+        code.add_constexpr('TEXT_KEYS[]', 'std::string_view', '{ %s }' % ', '.join('"%s"' % key for key in keys))
+        code.add_constexpr('TEXT_KEY_SEEDS[]', 'int32_t', '{ %s }' % ', '.join(str(seed) for seed in seeds))
+        code.add_constexpr('TEXT_KEY_SLOTS[]', 'uint16_t', '{ %s }' % ', '.join(str(slot) for slot in slots))
+
+        code.add_function('hash_text_key', 'constexpr uint32_t hash_text_key(std::string_view key, uint32_t seed)', '''
+            uint32_t value = 0x%08xu ^ seed;
+            for (char c : key)
+                value = (value ^ static_cast<uint8_t>(c)) * 0x%08xu;
+            value = (value ^ value >> 16) * 0x85ebca6bu;
+            value = (value ^ value >> 13) * 0xc2b2ae35u;
+            return value ^ value >> 16;''' % (FNV_OFFSET_BASIS, FNV_PRIME), priority=49)
+        code.add_function('find_text_id', 'constexpr std::optional<TextId> find_text_id(std::string_view key)', '''
+            /* Minimal perfect hash generated by tools/resource_packer/text_table_packer.py. */
+            int32_t seed = TEXT_KEY_SEEDS[hash_text_key(key, 0) % TEXT_ID_COUNT];
+            uint32_t slot = seed < 0 ? static_cast<uint32_t>(-seed - 1) : hash_text_key(key, static_cast<uint32_t>(seed)) % TEXT_ID_COUNT;
+            uint16_t id = TEXT_KEY_SLOTS[slot];
+            if (TEXT_KEYS[id] != key)
+                return std::nullopt;
+            return static_cast<TextId>(id);''')
@@ -0,0 +1,347 @@
+/*
+ * Headless self-play: plays full games between two AI policies on every core and writes one
+ * fixed-size record per game. No window, renderer or SDL is involved, so it runs on CI boxes.
+ *
+ *   poker_front_simulator [--games N] [--seed S] [--first POLICY] [--second POLICY]
+ *                         [--iterations N] [--threads N] [--output FILE]
+ *
+ * Policies are random, greedy and mcts. Game i gets the seed mix_seed(S, i), which deals its
+ * deck and seeds both policies, so a stored record seed replays its game alone. The first policy
+ * moves first in even games and second in odd ones. MCTS searches single-threaded with a
+ * fixed iteration budget, which keeps every game reproducible whatever the thread count.
+ *
+ * Output format, little endian: "PFSM", uint32 version, uint32 game count, then per game
+ * uint64 seed, int16 first policy score, int16 second policy score, uint8 plies, uint8 flags
+ * (bit 0: the first policy moved first), uint16 reserved.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/random.h"
+#include "common/thread_pool.h"
+#include "logic_core/board.h"
+#include "logic_core/dealer.h"
+#include "logic_core/mcts_player.h"
+#include "logic_core/rules.h"
+
+using namespace logic_core;
+
+namespace
+{
+    enum class PolicyType
+    {
+        Random,
+        Greedy,
+        Mcts,
+    };
+
+    struct SimulatorOptions
+    {
+        uint64_t game_count = 1000;
+        uint64_t seed = 1;
+        PolicyType first = PolicyType::Greedy;
+        PolicyType second = PolicyType::Random;
+        uint64_t mcts_iterations = 2000;
+        unsigned thread_count = 0;
+        const char* output_path = nullptr;
+    };
+
+    struct GameRecord
+    {
+        uint64_t seed;
+        int16_t first_score;
+        int16_t second_score;
+        uint8_t ply_count;
+        uint8_t flags;
+        uint16_t reserved;
+    };
+
+    static_assert(sizeof(GameRecord) == 16);
+
+    constexpr uint8_t FIRST_MOVED_FIRST = 1;
+    constexpr uint32_t RECORD_VERSION = 2;
+
+    /* Chooses placements for the side to move of its own view, see Board::get_view(). */
+    class Policy
+    {
+    public:
+        virtual ~Policy() = default;
+        virtual Move choose_move(const Board& view) = 0;
+        /* Told about every move played by either side. */
+        virtual void advance(const Move& move) { (void)move; }
+    };
+
+    class RandomPolicy : public Policy
+    {
+    public:
+        explicit RandomPolicy(uint64_t seed) : rng(seed) {}
+
+        Move choose_move(const Board& view) override
+        {
+            moves.resize(view.get_move_capacity());
+            int count = view.generate_moves(moves);
+            return moves[rng.next_below(count)];
+        }
+
+    private:
+        pf::Xoshiro256 rng;
+        std::vector<Move> moves;
+    };
+
+    /* Highest immediate score, ties broken at random. */
+    class GreedyPolicy : public Policy
+    {
+    public:
+        explicit GreedyPolicy(uint64_t seed) : rng(seed) {}
+
+        Move choose_move(const Board& view) override
+        {
+            moves.resize(view.get_move_capacity());
+            int count = view.generate_moves(moves);
+
+            Move best_move = moves[0];
+            int best_score = -1;
+            uint32_t tie_count = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                int score = view.get_placement_score(moves[i].x, moves[i].y, moves[i].get_card());
+                if (score > best_score)
+                {
+                    best_move = moves[i];
+                    best_score = score;
+                    tie_count = 1;
+                }
+                else if (score == best_score && rng.next_below(++tie_count) == 0)
+                {
+                    best_move = moves[i];
+                }
+            }
+            return best_move;
+        }
+
+    private:
+        pf::Xoshiro256 rng;
+        std::vector<Move> moves;
+    };
+
+    class MctsPolicy : public Policy
+    {
+    public:
+        MctsPolicy(uint64_t seed, uint64_t iterations) : player(make_options(seed, iterations)) {}
+
+        Move choose_move(const Board& view) override { return player.choose_move(view); }
+        void advance(const Move& move) override { player.advance(move); }
+
+    private:
+        static MctsOptions make_options(uint64_t seed, uint64_t iterations)
+        {
+            MctsOptions options;
+            options.time_budget = std::chrono::microseconds(0);
+            options.max_iterations = iterations;
+            options.node_capacity = static_cast<uint32_t>(std::min<uint64_t>(iterations * 4 + 2, 1 << 22));
+            options.seed = seed;
+            options.thread_count = 1;
+            return options;
+        }
+
+        MctsPlayer player;
+    };
+
+    const char* get_policy_name(PolicyType type)
+    {
+        switch (type)
+        {
+        case PolicyType::Random: return "random";
+        case PolicyType::Greedy: return "greedy";
+        case PolicyType::Mcts: return "mcts";
+        }
+        return "";
+    }
+
+    bool parse_policy(const char* name, PolicyType& out_type)
+    {
+        for (PolicyType type : { PolicyType::Random, PolicyType::Greedy, PolicyType::Mcts })
+        {
+            if (std::strcmp(name, get_policy_name(type)) == 0)
+            {
+                out_type = type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::unique_ptr<Policy> make_policy(PolicyType type, uint64_t seed, const SimulatorOptions& options)
+    {
+        switch (type)
+        {
+        case PolicyType::Random: return std::make_unique<RandomPolicy>(seed);
+        case PolicyType::Greedy: return std::make_unique<GreedyPolicy>(seed);
+        case PolicyType::Mcts: return std::make_unique<MctsPolicy>(seed, options.mcts_iterations);
+        }
+        return nullptr;
+    }
+
+    GameRecord play_game(uint64_t game_index, const SimulatorOptions& options)
+    {
+        GameRecord record = {};
+        record.seed = pf::mix_seed(options.seed, game_index);
+
+        /* The board is the full information state; each policy only gets its own view. */
+        Board board;
+        Dealer dealer(board.get_card_deck(), record.seed, 0);
+        for (int i = 0; i < STARTING_HAND_SIZE; ++i)
+        {
+            board.deal_to_hand(dealer.deal());
+            board.deal_to_rival(dealer.deal());
+        }
+
+        bool is_first_player = game_index % 2 == 0;
+        std::unique_ptr<Policy> first = make_policy(options.first, pf::mix_seed(record.seed, 1), options);
+        std::unique_ptr<Policy> second = make_policy(options.second, pf::mix_seed(record.seed, 2), options);
+        Policy* player = is_first_player ? first.get() : second.get();
+        Policy* rival = is_first_player ? second.get() : first.get();
+
+        while (!board.is_game_over())
+        {
+            Side side = board.get_side_to_move();
+            Policy* policy = side == Side::Player ? player : rival;
+            Move move = policy->choose_move(board.get_view(side));
+
+            player->advance(move);
+            rival->advance(move);
+
+            if (dealer.get_remaining_count() > 0)
+                move.draw = static_cast<uint8_t>(dealer.deal().to_index());
+            board.make_move(move);
+        }
+
+        int player_score = board.get_score(Side::Player);
+        int rival_score = board.get_score(Side::Rival);
+        record.first_score = static_cast<int16_t>(is_first_player ? player_score : rival_score);
+        record.second_score = static_cast<int16_t>(is_first_player ? rival_score : player_score);
+        record.ply_count = static_cast<uint8_t>(board.get_ply());
+        record.flags = is_first_player ? FIRST_MOVED_FIRST : 0;
+        return record;
+    }
+
+    bool write_records(const char* path, const std::vector<GameRecord>& records)
+    {
+        if (records.size() > UINT32_MAX)
+            return false;
+
+        FILE* file = std::fopen(path, "wb");
+        if (!file)
+            return false;
+
+        /* Records are written as laid out in memory, which is little endian on every target. */
+        uint32_t header[3] = { 0, RECORD_VERSION, static_cast<uint32_t>(records.size()) };
+        std::memcpy(header, "PFSM", 4);
+        bool is_ok = std::fwrite(header, sizeof(header), 1, file) == 1 &&
+            std::fwrite(records.data(), sizeof(GameRecord), records.size(), file) == records.size();
+        return std::fclose(file) == 0 && is_ok;
+    }
+
+    void print_usage()
+    {
+        std::fprintf(stderr,
+            "usage: poker_front_simulator [--games N] [--seed S] [--first POLICY] [--second POLICY]\n"
+            "                             [--iterations N] [--threads N] [--output FILE]\n"
+            "policies: random, greedy, mcts\n");
+    }
+
+    bool parse_arguments(int argc, char* argv[], SimulatorOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* name = argv[i];
+            if (i + 1 >= argc)
+                return false;
+            const char* value = argv[++i];
+
+            if (std::strcmp(name, "--games") == 0)
+                options.game_count = std::strtoull(value, nullptr, 10);
+            else if (std::strcmp(name, "--seed") == 0)
+                options.seed = std::strtoull(value, nullptr, 0);
+            else if (std::strcmp(name, "--first") == 0)
+            {
+                if (!parse_policy(value, options.first))
+                    return false;
+            }
+            else if (std::strcmp(name, "--second") == 0)
+            {
+                if (!parse_policy(value, options.second))
+                    return false;
+            }
+            else if (std::strcmp(name, "--iterations") == 0)
+                options.mcts_iterations = std::strtoull(value, nullptr, 10);
+            else if (std::strcmp(name, "--threads") == 0)
+                options.thread_count = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+            else if (std::strcmp(name, "--output") == 0)
+                options.output_path = value;
+            else
+                return false;
+        }
+        /* The output header counts games in 32 bits. */
+        if (options.output_path && options.game_count > UINT32_MAX)
+            return false;
+        return options.game_count > 0 && options.mcts_iterations > 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    SimulatorOptions options;
+    if (!parse_arguments(argc, argv, options))
+    {
+        print_usage();
+        return 2;
+    }
+
+    pf::ThreadPool thread_pool(options.thread_count);
+    std::vector<GameRecord> records(options.game_count);
+
+    auto start = std::chrono::steady_clock::now();
+    thread_pool.parallel_for(records.size(), [&](size_t i) {
+        records[i] = play_game(i, options);
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint64_t wins = 0;
+    uint64_t ties = 0;
+    uint64_t move_count = 0;
+    int64_t margin_sum = 0;
+    for (const GameRecord& record : records)
+    {
+        wins += record.first_score > record.second_score;
+        ties += record.first_score == record.second_score;
+        move_count += record.ply_count;
+        margin_sum += record.first_score - record.second_score;
+    }
+
+    double game_count = static_cast<double>(records.size());
+    std::printf("%s vs %s, %llu games on %u threads, seed %llu\n",
+        get_policy_name(options.first), get_policy_name(options.second),
+        static_cast<unsigned long long>(records.size()), thread_pool.get_thread_count(),
+        static_cast<unsigned long long>(options.seed));
+    std::printf("%s: %.1f%% wins, %.1f%% ties, %.1f%% losses, mean margin %+.2f\n",
+        get_policy_name(options.first), 100.0 * wins / game_count, 100.0 * ties / game_count,
+        100.0 * (game_count - wins - ties) / game_count, margin_sum / game_count);
+    std::printf("%.3f s, %.1f games/s, %.1f moves/s\n",
+        elapsed.count(), game_count / elapsed.count(), move_count / elapsed.count());
+
+    if (options.output_path && !write_records(options.output_path, records))
+    {
+        std::fprintf(stderr, "failed to write %s\n", options.output_path);
+        return 1;
+    }
+    return 0;
+}